@@ -1,1363 +1,6153 @@
-#include <raylib.h>
-#include "raymath.h"
-#include <Python.h>
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include <stdbool.h>
-#include <stdarg.h>
-#include <sys/stat.h>
-#include <direct.h>
-#include <dirent.h>
-#include <math.h>
-#include <ctype.h>
-
-#define MAX_OBJECTS 128
-#define NAME_LEN    32
-#define LOG_CAP     3
-#define CMD_LEN     256
-#define MAX_SCRIPTS 64
-#define LINE_LEN    128
-#define MAX_OPEN_EDITORS 16
-#define VISIBLE_LINES 20
-#define MAX_VARIABLES 64
-
-typedef enum { SHAPE_CIRCLE=0, SHAPE_RECT=1 } ShapeType;
-
-typedef struct {
-    char name[NAME_LEN];
-    Vector2 position;
-    float size;
-    Color color;
-    ShapeType shape;
-    bool selected;
-} GameObject;
-
-typedef struct {
-    char name[NAME_LEN];
-    float value;
-} Variable;
-
-typedef struct {
-    char name[NAME_LEN];
-    char lines[128][LINE_LEN];
-    int lineCount;
-    bool isScript;  // True for our custom scripting language
-    bool isPython;  // True for Python scripts
-} Script;
-
-typedef struct {
-    char name[NAME_LEN];
-    char lines[128][LINE_LEN];
-    int lineCount;
-    int scroll;
-    bool isScript;
-    bool isPython;
-} ScriptEditor;
-
-// Global variables for scripting
-static Variable variables[MAX_VARIABLES];
-static int variableCount = 0;
-static bool scriptRunning = false;
-static int currentScriptLine = 0;
-
-static GameObject objects[MAX_OBJECTS];
-static int objectCount = 0;
-
-static Script scripts[MAX_SCRIPTS];
-static int scriptCount = 0;
-
-static ScriptEditor openEditors[MAX_OPEN_EDITORS];
-static int openCount = 0;
-static int activeEditor = -1;
-static int caretLine=0, caretCol=0;
-
-static bool visualEditorOpen = false;
-static int selectedObject = -1; // For visual editor
-
-static char commandBuffer[CMD_LEN] = {0};
-static int commandLen = 0;
-static char logs[LOG_CAP][CMD_LEN];
-static int logCount = 0;
-static bool running = false;
-static bool dragging = false;
-static Vector2 dragOffset = {0};
-
-// --- Auto-suggest ---
-static char suggestions[MAX_SCRIPTS][NAME_LEN];
-static int suggestionCount = 0;
-static int highlightedSuggestion = -1;
-
-// Color scheme
-static const Color BG_DARK = {25, 25, 30, 255};
-static const Color BG_MEDIUM = {35, 35, 40, 255};
-static const Color BG_LIGHT = {45, 45, 50, 255};
-static const Color ACCENT_BLUE = {64, 128, 255, 255};
-static const Color ACCENT_GREEN = {64, 255, 128, 255};
-static const Color ACCENT_RED = {255, 64, 64, 255};
-static const Color ACCENT_ORANGE = {255, 165, 0, 255};
-static const Color ACCENT_PURPLE = {160, 64, 255, 255};
-static const Color TEXT_PRIMARY = {255, 255, 255, 255};
-static const Color TEXT_SECONDARY = {200, 200, 200, 255};
-
-// Forward declarations
-static void ExecuteCommand(const char* cmd);
-static void ExecuteScriptLine(const char* line);
-static float GetVariable(const char* name);
-static void SetVariable(const char* name, float value);
-static char currentProject[NAME_LEN] = "Default"; // Active project name
-
-
-// Measure width of first 'n' characters of a string using Raylib font
-float MeasureTextSubstring(const char *text, int n, int fontSize){
-    Font font = GetFontDefault();
-    char tmp[LINE_LEN] = {0};
-    strncpy(tmp, text, n);
-    tmp[n] = '\0';
-    return MeasureTextEx(font, tmp, (float)fontSize, 0).x;
-}
-
-// --- Logging ---
-static void AddLog(const char* fmt, ...) {
-    char line[CMD_LEN]; 
-    va_list args;
-    va_start(args, fmt); 
-    vsnprintf(line, sizeof(line), fmt, args); 
-    va_end(args);
-    
-    if(logCount < LOG_CAP) {
-        strcpy(logs[logCount++], line);
-    } else {
-        for(int i = 1; i < LOG_CAP; i++) {
-            strcpy(logs[i-1], logs[i]);
-        }
-        strcpy(logs[LOG_CAP-1], line);
-    }
-}
-
-// Initialize Python and set up game API
-static bool InitializePython() {
-    Py_Initialize();
-    if (!Py_IsInitialized()) {
-        AddLog("Failed to initialize Python");
-        return false;
-    }
-    
-    // Add game functions to Python environment
-    PyRun_SimpleString(
-        "# Game Engine API\n"
-        "game_objects = {}\n"
-        "game_variables = {}\n"
-        "game_commands = []\n"
-        "\n"
-        "def move_object(name, dx, dy):\n"
-        "    cmd = f'move {name} {dx} {dy}'\n"
-        "    game_commands.append(cmd)\n"
-        "    print(f'[Python] Moving {name} by {dx}, {dy}')\n"
-        "\n"
-        "def set_position(name, x, y):\n"
-        "    cmd = f'setPos {name} {x} {y}'\n"
-        "    game_commands.append(cmd)\n"
-        "    print(f'[Python] Setting {name} position to {x}, {y}')\n"
-        "\n"
-        "def set_color(name, r, g, b):\n"
-        "    cmd = f'color {name} {r} {g} {b}'\n"
-        "    game_commands.append(cmd)\n"
-        "    print(f'[Python] Setting {name} color to {r}, {g}, {b}')\n"
-        "\n"
-        "def create_circle(name, x, y, size, r, g, b):\n"
-        "    cmd = f'addCircle {name} {x} {y} {size} {r} {g} {b}'\n"
-        "    game_commands.append(cmd)\n"
-        "    print(f'[Python] Creating circle {name}')\n"
-        "\n"
-        "def create_rect(name, x, y, size, r, g, b):\n"
-        "    cmd = f'addRect {name} {x} {y} {size} {r} {g} {b}'\n"
-        "    game_commands.append(cmd)\n"
-        "    print(f'[Python] Creating rectangle {name}')\n"
-        "\n"
-        "def delete_obj(name):\n"
-        "    cmd = f'delete {name}'\n"
-        "    game_commands.append(cmd)\n"
-        "    print(f'[Python] Deleting object: {name}')\n"
-        "\n"
-        "def log_message(msg):\n"
-        "    print(f'[Python] {msg}')\n"
-        "\n"
-        "import math\n"
-        "import time\n"
-    );
-    
-    AddLog("Python initialized with game API");
-    return true;
-}
-
-// --- Variable System ---
-static float GetVariable(const char* name) {
-    for(int i = 0; i < variableCount; i++) {
-        if(strcmp(variables[i].name, name) == 0) {
-            return variables[i].value;
-        }
-    }
-    return 0.0f; // Default value
-}
-
-static void SetVariable(const char* name, float value) {
-    // Check if variable exists
-    for(int i = 0; i < variableCount; i++) {
-        if(strcmp(variables[i].name, name) == 0) {
-            variables[i].value = value;
-            return;
-        }
-    }
-    
-    // Create new variable
-    if(variableCount < MAX_VARIABLES) {
-        strncpy(variables[variableCount].name, name, NAME_LEN-1);
-        variables[variableCount].value = value;
-        variableCount++;
-    }
-}
-
-// --- Simple Expression Evaluator ---
-static float EvaluateExpression(const char* expr) {
-    char cleanExpr[256] = {0};
-    strncpy(cleanExpr, expr, 255);
-    
-    // Remove spaces
-    char* src = cleanExpr;
-    char* dst = cleanExpr;
-    while(*src) {
-        if(*src != ' ') *dst++ = *src;
-        src++;
-    }
-    *dst = '\0';
-    
-    // Simple evaluation - handles basic math and variables
-    if(isdigit(cleanExpr[0]) || cleanExpr[0] == '-') {
-        return atof(cleanExpr);
-    }
-    
-    // Check for simple operations
-    char* plus = strchr(cleanExpr, '+');
-    char* minus = strchr(cleanExpr, '-');
-    char* mult = strchr(cleanExpr, '*');
-    char* div = strchr(cleanExpr, '/');
-    
-    if(plus) {
-        *plus = '\0';
-        return EvaluateExpression(cleanExpr) + EvaluateExpression(plus + 1);
-    }
-    if(minus && minus != cleanExpr) { // Not negative number
-        *minus = '\0';
-        return EvaluateExpression(cleanExpr) - EvaluateExpression(minus + 1);
-    }
-    if(mult) {
-        *mult = '\0';
-        return EvaluateExpression(cleanExpr) * EvaluateExpression(mult + 1);
-    }
-    if(div) {
-        *div = '\0';
-        float denominator = EvaluateExpression(div + 1);
-        return denominator != 0 ? EvaluateExpression(cleanExpr) / denominator : 0;
-    }
-    
-    // Check for math functions
-    if(strncmp(cleanExpr, "sin(", 4) == 0) {
-        char* end = strchr(cleanExpr, ')');
-        if(end) {
-            *end = '\0';
-            return sin(EvaluateExpression(cleanExpr + 4) * PI / 180.0f);
-        }
-    }
-    if(strncmp(cleanExpr, "cos(", 4) == 0) {
-        char* end = strchr(cleanExpr, ')');
-        if(end) {
-            *end = '\0';
-            return cos(EvaluateExpression(cleanExpr + 4) * PI / 180.0f);
-        }
-    }
-    
-    // Must be a variable
-    return GetVariable(cleanExpr);
-}
-
-// --- Objects ---
-static GameObject* FindByName(const char* name){
-    for(int i = 0; i < objectCount; i++) if(strcmp(objects[i].name, name) == 0) return &objects[i];
-    return NULL;
-}
-
-static bool NameExists(const char* name){ return FindByName(name)!=NULL; }
-
-static void AddObject(const char* name, ShapeType shape, Vector2 pos, float size, Color col){
-    if(objectCount >= MAX_OBJECTS){ AddLog("Error: object limit reached"); return; }
-    if(NameExists(name)){ AddLog("Error: name '%s' exists", name); return; }
-    GameObject o = {0};
-    strncpy(o.name, name, NAME_LEN-1);
-    o.position = pos; o.size = (size <= 0 ? 1 : size); o.color = col; o.shape = shape; o.selected = false;
-    objects[objectCount++] = o;
-    AddLog("Added %s '%s'", shape==SHAPE_CIRCLE?"circle":"rect", name);
-}
-
-static void DeleteObject(const char* name){
-    for(int i=0;i<objectCount;i++){
-        if(strcmp(objects[i].name,name)==0){
-            for(int j=i+1;j<objectCount;j++) objects[j-1]=objects[j];
-            objectCount--; AddLog("Deleted '%s'",name); return;
-        }
-    }
-    AddLog("Error: '%s' not found",name);
-}
-
-// --- Project / Script files ---
-static void CreateDirIfNotExist(const char* path){ _mkdir(path); }
-
-static void UpdateProject(const char* name){
-    strncpy(currentProject, name, NAME_LEN-1);
-    currentProject[NAME_LEN-1] = '\0'; // safe terminate
-    char path[256]; snprintf(path,sizeof(path),"./Projects/%s",name);
-    CreateDirIfNotExist("./Projects"); CreateDirIfNotExist(path);
-    char mainFile[256]; snprintf(mainFile,sizeof(mainFile),"%s/main.game",path);
-    FILE *f = fopen(mainFile,"w");
-    if(f){ 
-        fprintf(f,"# %s Project\n",name);
-        for(int i=0;i<objectCount;i++){ GameObject* o=&objects[i];
-            fprintf(f,"%s %s %.0f %.0f %.0f %d %d %d\n",
-                o->shape==SHAPE_CIRCLE?"circle":"rect", o->name, o->position.x,o->position.y,o->size,
-                o->color.r,o->color.g,o->color.b);
-        }
-        fclose(f);
-    }
-    char scriptsDir[256]; snprintf(scriptsDir,sizeof(scriptsDir),"%s/scripts",path);
-    CreateDirIfNotExist(scriptsDir);
-    AddLog("Project '%s' updated", name);
-}
-
-static void LoadScripts(const char* projectName){
-    scriptCount = 0;
-    char path[256]; snprintf(path,sizeof(path),"./Projects/%s/scripts",projectName);
-    DIR *dir = opendir(path);
-    if(!dir){ AddLog("No scripts folder"); return; }
-    struct dirent *entry;
-    while((entry=readdir(dir))!=NULL){
-        if(strcmp(entry->d_name,".")==0 || strcmp(entry->d_name,"..")==0) continue;
-        if(scriptCount >= MAX_SCRIPTS) break;
-        Script *s = &scripts[scriptCount]; s->lineCount=0;
-        strncpy(s->name, entry->d_name, NAME_LEN-1);
-        
-        // Check file type
-        s->isScript = (strstr(entry->d_name, ".script") != NULL);
-        s->isPython = (strstr(entry->d_name, ".py") != NULL);
-        
-        char filePath[256]; snprintf(filePath,sizeof(filePath),"%s/%s", path, entry->d_name);
-        FILE *f=fopen(filePath,"r"); if(!f) continue;
-        while(fgets(s->lines[s->lineCount], LINE_LEN, f) && s->lineCount<128){
-            char *p=strchr(s->lines[s->lineCount],'\n'); if(p)*p=0;
-            s->lineCount++;
-        }
-        fclose(f); scriptCount++;
-        
-        const char* typeStr = s->isPython ? "Python script" : (s->isScript ? "custom script" : "file");
-        AddLog("Loaded %s '%s'", typeStr, s->name);
-    }
-    closedir(dir);
-}
-
-static void SaveScript(ScriptEditor* ed){
-    char scriptsDir[256];
-    snprintf(scriptsDir, sizeof(scriptsDir), "./Projects/%s/scripts", currentProject);
-    CreateDirIfNotExist("./Projects");
-    CreateDirIfNotExist(scriptsDir);
-
-    char path[256];
-    snprintf(path, sizeof(path), "%s/%s", scriptsDir, ed->name);
-
-    FILE *f = fopen(path,"w");
-    if(!f){ 
-        AddLog("Failed to save '%s'", ed->name); 
-        return; 
-    }
-    for(int i=0;i<ed->lineCount;i++) {
-        fprintf(f,"%s\n", ed->lines[i]);
-    }
-    fclose(f);
-    AddLog("Saved '%s' in project '%s'", ed->name, currentProject);
-}
-
-// --- Enhanced Script Execution ---
-static void ExecuteScriptLine(const char* line) {
-    if(strlen(line) == 0 || line[0] == '#') return;
-    
-    char cmd[CMD_LEN];
-    strncpy(cmd, line, CMD_LEN-1);
-    cmd[CMD_LEN-1] = '\0';
-    
-    char word[64];
-    if(sscanf(cmd, "%63s", word) != 1) return;
-    
-    // Variable assignment: var = expression
-    char* equals = strchr(cmd, '=');
-    if(equals) {
-        *equals = '\0';
-        char varName[64];
-        sscanf(cmd, "%63s", varName);
-        float value = EvaluateExpression(equals + 1);
-        SetVariable(varName, value);
-        AddLog("[Script] %s = %.2f", varName, value);
-        return;
-    }
-    
-    // Move object: move objectName deltaX deltaY
-    if(strcmp(word, "move") == 0) {
-        char objName[NAME_LEN];
-        char dxExpr[64], dyExpr[64];
-        if(sscanf(cmd, "move %31s %63s %63s", objName, dxExpr, dyExpr) == 3) {
-            GameObject* obj = FindByName(objName);
-            if(obj) {
-                float dx = EvaluateExpression(dxExpr);
-                float dy = EvaluateExpression(dyExpr);
-                obj->position = Vector2Add(obj->position, (Vector2){dx, dy});
-            }
-        }
-        return;
-    }
-    
-    // Set position: setPos objectName x y
-    if(strcmp(word, "setPos") == 0) {
-        char objName[NAME_LEN];
-        char xExpr[64], yExpr[64];
-        if(sscanf(cmd, "setPos %31s %63s %63s", objName, xExpr, yExpr) == 3) {
-            GameObject* obj = FindByName(objName);
-            if(obj) {
-                float x = EvaluateExpression(xExpr);
-                float y = EvaluateExpression(yExpr);
-                obj->position = (Vector2){x, y};
-            }
-        }
-        return;
-    }
-    
-    // Set color: setColor objectName r g b
-    if(strcmp(word, "setColor") == 0) {
-        char objName[NAME_LEN];
-        char rExpr[64], gExpr[64], bExpr[64];
-        if(sscanf(cmd, "setColor %31s %63s %63s %63s", objName, rExpr, gExpr, bExpr) == 4) {
-            GameObject* obj = FindByName(objName);
-            if(obj) {
-                int r = (int)EvaluateExpression(rExpr);
-                int g = (int)EvaluateExpression(gExpr);
-                int b = (int)EvaluateExpression(bExpr);
-                obj->color = (Color){r, g, b, 255};
-            }
-        }
-        return;
-    }
-    
-    // Create circle: createCircle name x y size r g b
-    if(strcmp(word, "createCircle") == 0) {
-        char objName[NAME_LEN];
-        char args[6][64];
-        if(sscanf(cmd, "createCircle %31s %63s %63s %63s %63s %63s %63s", 
-                 objName, args[0], args[1], args[2], args[3], args[4], args[5]) == 7) {
-            float x = EvaluateExpression(args[0]);
-            float y = EvaluateExpression(args[1]);
-            float size = EvaluateExpression(args[2]);
-            int r = (int)EvaluateExpression(args[3]);
-            int g = (int)EvaluateExpression(args[4]);
-            int b = (int)EvaluateExpression(args[5]);
-            AddObject(objName, SHAPE_CIRCLE, (Vector2){x, y}, size, (Color){r, g, b, 255});
-        }
-        return;
-    }
-    
-    // Create rectangle: createRect name x y size r g b
-    if(strcmp(word, "createRect") == 0) {
-        char objName[NAME_LEN];
-        char args[6][64];
-        if(sscanf(cmd, "createRect %31s %63s %63s %63s %63s %63s %63s", 
-                 objName, args[0], args[1], args[2], args[3], args[4], args[5]) == 7) {
-            float x = EvaluateExpression(args[0]);
-            float y = EvaluateExpression(args[1]);
-            float size = EvaluateExpression(args[2]);
-            int r = (int)EvaluateExpression(args[3]);
-            int g = (int)EvaluateExpression(args[4]);
-            int b = (int)EvaluateExpression(args[5]);
-            AddObject(objName, SHAPE_RECT, (Vector2){x, y}, size, (Color){r, g, b, 255});
-        }
-        return;
-    }
-    
-    // Log message: log "message"
-    if(strcmp(word, "log") == 0) {
-        char* quote1 = strchr(cmd, '"');
-        if(quote1) {
-            quote1++; // Skip opening quote
-            char* quote2 = strchr(quote1, '"');
-            if(quote2) {
-                *quote2 = '\0';
-                AddLog("[Script] %s", quote1);
-            }
-        }
-        return;
-    }
-    
-    // For loop: for var start end
-    if(strcmp(word, "for") == 0) {
-        // This would need more complex parsing for full implementation
-        // For now, just log it
-        AddLog("[Script] For loop detected");
-        return;
-    }
-}
-
-static void ExecuteScript(const char* scriptName) {
-    // Find the script
-    Script *script = NULL;
-    for(int i = 0; i < scriptCount; i++) {
-        if(strcmp(scripts[i].name, scriptName) == 0) {
-            script = &scripts[i];
-            break;
-        }
-    }
-    
-    if(!script) {
-        AddLog("Script '%s' not found", scriptName);
-        return;
-    }
-    
-    // Execute all lines
-    for(int i = 0; i < script->lineCount; i++) {
-        ExecuteScriptLine(script->lines[i]);
-    }
-    
-    AddLog("Executed script '%s'", scriptName);
-}
-
-// Execute Python script and capture commands
-    static void ExecutePythonScript(const char* scriptName) {
-        // Build the full file path
-        char scriptPath[256];
-        snprintf(scriptPath, sizeof(scriptPath), "./Projects/%s/scripts/%s", currentProject, scriptName);
-        
-        // Check if file exists
-        FILE* testFile = fopen(scriptPath, "r");
-        if(!testFile) {
-            AddLog("Python script file '%s' not found at path: %s", scriptName, scriptPath);
-            return;
-        }
-        fclose(testFile);
-        
-        // Clear previous commands
-        PyRun_SimpleString("game_commands.clear()");
-        
-        // Read the file content
-        FILE* file = fopen(scriptPath, "r");
-        if(!file) {
-            AddLog("Failed to open Python script '%s'", scriptName);
-            return;
-        }
-        
-        char pythonCode[8192] = {0}; // Adjust size as needed
-        char line[256];
-        while(fgets(line, sizeof(line), file)) {
-            strcat(pythonCode, line);
-        }
-        fclose(file);
-        
-        // Execute the Python script
-        if(PyRun_SimpleString(pythonCode) != 0) {
-            AddLog("Python script execution failed for '%s'", scriptName);
-            return;
-        }
-        
-        // Get and execute the generated commands
-        PyObject* commandsList = PyObject_GetAttrString(PyImport_AddModule("__main__"), "game_commands");
-        if(commandsList && PyList_Check(commandsList)) {
-            Py_ssize_t size = PyList_Size(commandsList);
-            for(Py_ssize_t i = 0; i < size; i++) {
-                PyObject* item = PyList_GetItem(commandsList, i);
-                if(PyUnicode_Check(item)) {
-                    const char* cmd = PyUnicode_AsUTF8(item);
-                    if(cmd) {
-                        ExecuteCommand(cmd);
-                    }
-                }
-            }
-        }
-        
-        AddLog("Executed Python script '%s' from project '%s'", scriptName, currentProject);
-    }
-
-// --- Editor Utilities ---
-static void OpenScriptTab(const char* name){
-    for(int i=0;i<openCount;i++){ if(strcmp(openEditors[i].name,name)==0){ activeEditor=i; return; } }
-    if(openCount>=MAX_OPEN_EDITORS) return;
-    ScriptEditor* ed=&openEditors[openCount];
-    strncpy(ed->name,name,NAME_LEN-1); ed->lineCount=1; ed->scroll=0;
-    strcpy(ed->lines[0], "");
-    
-    // Check file type
-    ed->isScript = (strstr(name, ".script") != NULL);
-    ed->isPython = (strstr(name, ".py") != NULL);
-    
-    // Load from existing script if found
-    for(int i=0;i<scriptCount;i++) if(strcmp(scripts[i].name,name)==0){
-        ed->lineCount = scripts[i].lineCount;
-        ed->isScript = scripts[i].isScript;
-        ed->isPython = scripts[i].isPython;
-        for(int j=0;j<scripts[i].lineCount;j++) strcpy(ed->lines[j],scripts[i].lines[j]);
-        break;
-    }
-    activeEditor=openCount;
-    openCount++;
-    caretLine = 0;
-    caretCol = 0;
-    const char* typeStr = ed->isPython ? "Python script" : (ed->isScript ? "custom script" : "file");
-    AddLog("Opened %s '%s'", typeStr, name);
-}
-
-// --- Command execution ---
-static void ExecuteCommand(const char* cmd){
-    char word[32]={0}; if(sscanf(cmd,"%31s",word)!=1){AddLog("Empty command"); return;}
-    if(strcmp(word,"addCircle")==0){
-        char name[NAME_LEN]; int x,y; float size; int r,g,b;
-        if(sscanf(cmd,"addCircle %31s %d %d %f %d %d %d",name,&x,&y,&size,&r,&g,&b)==7)
-            AddObject(name,SHAPE_CIRCLE,(Vector2){x,y},size,(Color){r,g,b,255});
-        else AddLog("Usage: addCircle name x y size r g b");
-    }
-    else if(strcmp(word,"addRect")==0){
-        char name[NAME_LEN]; int x,y; float size; int r,g,b;
-        if(sscanf(cmd,"addRect %31s %d %d %f %d %d %d",name,&x,&y,&size,&r,&g,&b)==7)
-            AddObject(name,SHAPE_RECT,(Vector2){x,y},size,(Color){r,g,b,255});
-        else AddLog("Usage: addRect name x y size r g b");
-    }
-    else if(strcmp(word,"move")==0){
-        char name[NAME_LEN]; float dx,dy;
-        if(sscanf(cmd,"move %31s %f %f",name,&dx,&dy)==3){
-            GameObject *o=FindByName(name);
-            if(o){ o->position=Vector2Add(o->position,(Vector2){dx,dy}); AddLog("Moved '%s'",name);}
-            else AddLog("Error: '%s' not found",name);
-        } else AddLog("Usage: move name dx dy");
-    }
-    else if(strcmp(word,"color")==0){
-        char name[NAME_LEN]; int r,g,b;
-        if(sscanf(cmd,"color %31s %d %d %d",name,&r,&g,&b)==4){
-            GameObject *o=FindByName(name);
-            if(o){ o->color=(Color){r,g,b,255}; AddLog("Recolored '%s'",name);}
-            else AddLog("Error: '%s' not found",name);
-        } else AddLog("Usage: color name r g b");
-    }
-    else if(strcmp(word,"update")==0){
-        char name[NAME_LEN]; if(sscanf(cmd,"update %31s",name)==1) UpdateProject(name);
-        else AddLog("Usage: update ProjectName");
-    }
-    else if(strcmp(word,"OpenScript")==0){
-        char scriptName[NAME_LEN];
-        if(sscanf(cmd,"OpenScript %31s",scriptName)==1) OpenScriptTab(scriptName);
-        else AddLog("Usage: OpenScript <script>");
-    }
-    else if(strcmp(word,"NewScript")==0){
-        char scriptName[NAME_LEN];
-        if(sscanf(cmd,"NewScript %31s",scriptName)==1) {
-            // Add .script extension if not present
-            char fullName[NAME_LEN];
-            if(strstr(scriptName, ".script") == NULL) {
-                snprintf(fullName, sizeof(fullName), "%s.script", scriptName);
-            } else {
-                strncpy(fullName, scriptName, NAME_LEN-1);
-            }
-            OpenScriptTab(fullName);
-        } else AddLog("Usage: NewScript <name>");
-    }
-    else if(strcmp(word,"NewPython")==0){
-        char scriptName[NAME_LEN];
-        if(sscanf(cmd,"NewPython %31s",scriptName)==1) {
-            char fullName[NAME_LEN];
-            if(strstr(scriptName, ".py") == NULL) {
-                snprintf(fullName, sizeof(fullName), "%s.py", scriptName);
-            } else {
-                strncpy(fullName, scriptName, NAME_LEN-1);
-            }
-            OpenScriptTab(fullName);
-        } else AddLog("Usage: NewPython <name>");
-    }
-    else if(strcmp(word,"RunScript")==0){
-        char scriptName[NAME_LEN];
-        if(sscanf(cmd,"RunScript %31s",scriptName)==1) ExecuteScript(scriptName);
-        else AddLog("Usage: RunScript <script>");
-    }
-    else if(strcmp(word,"RunPython")==0){
-        char scriptName[NAME_LEN];
-        if(sscanf(cmd,"RunPython %31s",scriptName)==1) ExecutePythonScript(scriptName);
-        else AddLog("Usage: RunPython <script.py>");
-    }
-    else if(strcmp(word,"set")==0){
-        char varName[NAME_LEN]; float value;
-        if(sscanf(cmd,"set %31s %f",varName,&value)==2) {
-            SetVariable(varName, value);
-            AddLog("Set %s = %.2f", varName, value);
-        } else AddLog("Usage: set varName value");
-    }
-    else if(strcmp(word,"delete")==0){
-        char name[NAME_LEN];
-        if(sscanf(cmd,"delete %31s",name)==1) {
-            DeleteObject(name);
-        } else {
-            AddLog("Usage: delete objectName");
-        }
-    }
-    else AddLog("Unknown command: %s",word);
-}
-
-// --- Mouse/Object utilities ---
-static void ClearSelection(void){for(int i=0;i<objectCount;i++)objects[i].selected=false;}
-static bool PointInObject(Vector2 p,const GameObject* o){
-    if(o->shape==SHAPE_CIRCLE) return Vector2Distance(p,o->position)<=o->size;
-    return (p.x>=o->position.x-o->size && p.x<=o->position.x+o->size && p.y>=o->position.y-o->size && p.y<=o->position.y+o->size);
-}
-
-// Simple syntax highlighting for our scripting language
-static Color GetScriptTokenColor(const char* token) {
-    // Keywords
-    const char* keywords[] = {"move", "setPos", "setColor", "createCircle", "createRect", 
-                             "log", "for", "if", "while", "end"};
-    int keywordCount = sizeof(keywords) / sizeof(keywords[0]);
-    
-    for(int i = 0; i < keywordCount; i++) {
-        if(strcmp(token, keywords[i]) == 0) {
-            return ACCENT_BLUE;
-        }
-    }
-    
-    // Numbers
-    if(isdigit(token[0]) || (token[0] == '-' && isdigit(token[1]))) {
-        return ACCENT_ORANGE;
-    }
-    
-    // Strings
-    if(token[0] == '"') {
-        return ACCENT_GREEN;
-    }
-    
-    // Variables (common names)
-    if(strcmp(token, "x") == 0 || strcmp(token, "y") == 0 || 
-       strcmp(token, "i") == 0 || strcmp(token, "angle") == 0) {
-        return ACCENT_PURPLE;
-    }
-    
-    return TEXT_PRIMARY;
-}
-
-// Add Python syntax highlighting
-static Color GetPythonTokenColor(const char* token) {
-    // Python keywords - expanded list
-    const char* keywords[] = {
-        "and", "assert", "break", "class", "continue", "def",
-        "del", "elif", "else", "except", "exec", "finally",
-        "for", "from", "global", "if", "import", "in",
-        "is", "lambda", "not", "or", "pass", "print",
-        "raise", "return", "try", "while", "yield",
-        "None", "True", "False"
-    };
-    int keywordCount = sizeof(keywords) / sizeof(keywords[0]);
-    
-    for(int i = 0; i < keywordCount; i++) {
-        if(strcmp(token, keywords[i]) == 0) {
-            return ACCENT_BLUE;
-        }
-    }
-    
-    // Python built-in functions
-    const char* builtins[] = {"len", "range", "str", "int", "float", "list", "dict", "open", "abs", "min", "max"};
-    int builtinCount = sizeof(builtins) / sizeof(builtins[0]);
-    
-    for(int i = 0; i < builtinCount; i++) {
-        if(strcmp(token, builtins[i]) == 0) {
-            return ACCENT_PURPLE;
-        }
-    }
-    
-    // Game API functions
-    const char* gameAPI[] = {"move_object", "set_position", "set_color", "create_circle", "create_rect", "log_message"};
-    int gameAPICount = sizeof(gameAPI) / sizeof(gameAPI[0]);
-    
-    for(int i = 0; i < gameAPICount; i++) {
-        if(strcmp(token, gameAPI[i]) == 0) {
-            return ACCENT_GREEN;
-        }
-    }
-    
-    // Numbers
-    if(isdigit(token[0]) || (token[0] == '-' && isdigit(token[1]))) {
-        return ACCENT_ORANGE;
-    }
-    
-    // Strings
-    if(token[0] == '"' || token[0] == '\'') {
-        return ACCENT_GREEN;
-    }
-    
-    return TEXT_PRIMARY;
-}
-
-// --- Main ---
-int main(void){
-    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
-    InitWindow(1200,800,"2D Game Engine with Python Integration");
-    SetTargetFPS(60);
-    // Load custom font
-    Font customFont = LoadFont("C:/Fonts/Codey/static/SourceCodePro-Bold.ttf");
-    if (customFont.texture.id == 0) {
-        // Fallback to default if font fails to load
-        customFont = GetFontDefault();
-        AddLog("Failed to load custom font, using default");
-    } else {
-        AddLog("Custom font loaded successfully");
-    }
-
-    // Initialize Python
-    if(!InitializePython()) {
-        AddLog("Warning: Python initialization failed");
-    }
-
-    AddObject("player",SHAPE_CIRCLE,(Vector2){500,300},40,ACCENT_RED);
-    AddObject("box",SHAPE_RECT,(Vector2){700,350},50,ACCENT_BLUE);
-
-    CreateDirIfNotExist("./Projects/Default/scripts");
-    LoadScripts(currentProject);
-
-    // Initialize some example variables
-    SetVariable("speed", 5.0f);
-    SetVariable("angle", 0.0f);
-
-    Rectangle playButton={(float)GetScreenWidth()-120,10,100,40};
-
-    int editorCharY = 18;
-
-    while(!WindowShouldClose()){
-        const int screenW = GetScreenWidth();
-        const int screenH = GetScreenHeight();
-        const int commandBarH=40;
-        const int logBarH=80;
-        const int tabBarH=35;
-        const int leftPanelW=220;
-        const int bottomH=commandBarH+logBarH;
-
-        Vector2 mouse=GetMousePosition();
-
-        // --- Input handling ---
-        int ch = GetCharPressed();
-        while(ch > 0) {
-            if(activeEditor >= 0 && !visualEditorOpen) {
-                // Script editor input
-                ScriptEditor *ed = &openEditors[activeEditor];
-                if(caretLine >= ed->lineCount) caretLine = ed->lineCount - 1;
-                if(caretLine < 0) caretLine = 0;
-                caretCol = Clamp(caretCol, 0, strlen(ed->lines[caretLine]));
-                
-                if(ch >= 32 && ch <= 125){
-                    int len = strlen(ed->lines[caretLine]);
-                    if(len < LINE_LEN-1 && caretCol <= len){
-                        // Shift characters to the right, including null terminator
-                        memmove(&ed->lines[caretLine][caretCol+1], 
-                                &ed->lines[caretLine][caretCol], 
-                                len - caretCol + 1);
-                        // Insert the new character
-                        ed->lines[caretLine][caretCol] = (char)ch;
-                        caretCol++;
-                        if(caretLine >= ed->scroll + VISIBLE_LINES) ed->scroll++;
-                    }
-                }
-            } else {
-                // Visual editor or no editor - input goes to command bar
-                if(ch >= 32 && ch <= 125 && commandLen < CMD_LEN-1){
-                    commandBuffer[commandLen++] = (char)ch;
-                    commandBuffer[commandLen] = '\0';
-                }
-            }
-            ch = GetCharPressed();
-        }
-
-        // --- Backspace / Enter ---
-        if(activeEditor >= 0 && !visualEditorOpen){
-            ScriptEditor *ed = &openEditors[activeEditor];
-            if(IsKeyPressed(KEY_BACKSPACE) && caretCol>0){
-                int len=strlen(ed->lines[caretLine]);
-                for(int i=caretCol-1;i<len;i++) ed->lines[caretLine][i]=ed->lines[caretLine][i+1];
-                caretCol--;
-            }
-            if(IsKeyPressed(KEY_ENTER)){
-                if(ed->lineCount<128){
-                    for(int i=ed->lineCount;i>caretLine+1;i--) strcpy(ed->lines[i],ed->lines[i-1]);
-                    ed->lines[caretLine+1][0]=0;
-                    caretLine++; caretCol=0; ed->lineCount++;
-                    if(caretLine >= ed->scroll + VISIBLE_LINES) ed->scroll++;
-                }
-            }
-            // Arrow keys
-            if(IsKeyPressed(KEY_UP)){ if(caretLine>0) caretLine--; caretCol=Clamp(caretCol,0,(int)strlen(ed->lines[caretLine])); if(caretLine<ed->scroll) ed->scroll--; }
-            if(IsKeyPressed(KEY_DOWN)){ if(caretLine<ed->lineCount-1) caretLine++; caretCol=Clamp(caretCol,0,(int)strlen(ed->lines[caretLine])); if(caretLine>=ed->scroll+VISIBLE_LINES) ed->scroll++; }
-            if(IsKeyPressed(KEY_LEFT) && caretCol>0) caretCol--;
-            if(IsKeyPressed(KEY_RIGHT) && caretCol<(int)strlen(ed->lines[caretLine])) caretCol++;
-            
-            // Ctrl+S to save
-            if(IsKeyDown(KEY_LEFT_CONTROL) && IsKeyPressed(KEY_S)) SaveScript(ed);
-            
-            // F5 to run script
-            if(IsKeyPressed(KEY_F5)) {
-                SaveScript(ed);
-                if(ed->isPython) {
-                    ExecutePythonScript(ed->name);
-                } else if(ed->isScript) {
-                    ExecuteScript(ed->name);
-                }
-            }
-        } else {
-            // Visual editor or command bar input
-            if(IsKeyPressed(KEY_BACKSPACE) && commandLen>0){ commandLen--; commandBuffer[commandLen]='\0'; }
-            if(IsKeyPressed(KEY_ENTER) && commandLen>0){ ExecuteCommand(commandBuffer); commandLen=0; commandBuffer[0]='\0'; }
-        }
-
-        if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON)){
-            int totalTabs = openCount + 1;
-            float tabW = (float)screenW / totalTabs;
-            
-            // Check visual editor tab
-            Rectangle visualTab = {0, 0, tabW, tabBarH};
-            if(CheckCollisionPointRec(mouse, visualTab)){
-                visualEditorOpen = true;
-                activeEditor = -1;
-            } else {
-                // Check script editor tabs
-                for(int i=0;i<openCount;i++){
-                    Rectangle tab={(i+1)*tabW,0,tabW,tabBarH};
-                    if(CheckCollisionPointRec(mouse, tab)){
-                        activeEditor = i;
-                        visualEditorOpen = false;
-                        caretLine = 0;
-                        caretCol = 0;
-                        break;
-                    }
-                }
-            }
-        }
-
-        // --- Auto-suggest ---
-        suggestionCount=0; highlightedSuggestion=-1;
-        if(strncmp(commandBuffer,"OpenScript ",11)==0){
-            const char* partial = commandBuffer+11;
-            for(int i=0;i<scriptCount;i++){
-                if(strncmp(scripts[i].name, partial, strlen(partial))==0){
-                    strncpy(suggestions[suggestionCount], scripts[i].name, NAME_LEN-1);
-                    suggestionCount++; if(suggestionCount>=MAX_SCRIPTS) break;
-                }
-            }
-        }
-
-        // --- Object dragging ---
-        Rectangle canvas = {(float)leftPanelW, tabBarH, (float)(screenW-leftPanelW), (float)(screenH-bottomH-tabBarH)};
-        if(CheckCollisionPointRec(mouse, canvas)){
-            if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON)){
-                dragging=false; int picked=-1;
-                for(int i=objectCount-1;i>=0;i--) if(PointInObject(mouse,&objects[i])){picked=i; break;}
-                if(picked>=0){ ClearSelection(); objects[picked].selected=true; dragOffset=Vector2Subtract(objects[picked].position,mouse); dragging=true; AddLog("Selected '%s'",objects[picked].name);}
-                else ClearSelection();
-            }
-            if(IsMouseButtonDown(MOUSE_LEFT_BUTTON) && dragging) for(int i=0;i<objectCount;i++) if(objects[i].selected) objects[i].position=Vector2Add(mouse,dragOffset);
-            if(IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) dragging=false;
-        } else if(IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) dragging=false;
-
-        // --- Run scripts ---
-        if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mouse,playButton)) running=!running;
-        if(running){
-            for(int s=0;s<scriptCount;s++){
-                Script *sc=&scripts[s];
-                if(sc->isScript) {
-                    // Skip scripts in auto-run mode - use F5 or RunScript command instead
-                    continue;
-                } else {
-                    for(int l=0;l<sc->lineCount;l++) ExecuteScriptLine(sc->lines[l]);
-                }
-            }
-        }
-
-        // Update variables for animation
-        if(running) {
-            float currentAngle = GetVariable("angle");
-            SetVariable("angle", currentAngle + 2.0f);
-            if(currentAngle > 360) SetVariable("angle", 0);
-        }
-
-        // --- Draw ---
-        BeginDrawing();
-        ClearBackground(BG_DARK);
-
-        // Calculate tab width (including visual editor tab)
-        int totalTabs = openCount + 1; // +1 for visual editor
-        float tabW = (float)screenW / totalTabs;
-
-        // Draw visual editor tab first
-        Rectangle visualTab = {0, 0, tabW, tabBarH};
-        Color visualTabColor = visualEditorOpen ? BG_LIGHT : BG_MEDIUM;
-        DrawRectangleRec(visualTab, visualTabColor);
-        if(visualEditorOpen) {
-            DrawRectangle(visualTab.x, visualTab.y + visualTab.height - 3, visualTab.width, 3, ACCENT_BLUE);
-        }
-        DrawTextEx(customFont, "Visual Editor", (Vector2){visualTab.x+10, visualTab.y+8}, 16, 0, TEXT_PRIMARY);
-
-        // Draw script editor tabs
-        for(int i=0;i<openCount;i++){
-            Rectangle tab={(i+1)*tabW,0,tabW,tabBarH}; // +1 to account for visual editor tab
-            Color tabColor = (i == activeEditor && !visualEditorOpen) ? BG_LIGHT : BG_MEDIUM;
-            DrawRectangleRec(tab, tabColor);
-            if(i == activeEditor && !visualEditorOpen) {
-                DrawRectangle(tab.x, tab.y + tab.height - 3, tab.width, 3, ACCENT_BLUE);
-            }
-            
-            // Draw script indicators and names (your existing code)
-            if(openEditors[i].isPython) {
-                DrawTextEx(customFont, "Python", (Vector2){tab.x+5, tab.y+5}, 10, 0, ACCENT_GREEN);
-                DrawTextEx(customFont, openEditors[i].name, (Vector2){tab.x+45, tab.y+8}, 16, 0, TEXT_PRIMARY);
-            } else if(openEditors[i].isScript) {
-                DrawTextEx(customFont, "Script", (Vector2){tab.x+5, tab.y+5}, 10, 0, ACCENT_PURPLE);
-                DrawTextEx(customFont, openEditors[i].name, (Vector2){tab.x+45, tab.y+8}, 16, 0, TEXT_PRIMARY);
-            } else {
-                DrawTextEx(customFont, openEditors[i].name, (Vector2){tab.x+10, tab.y+8}, 16, 0, TEXT_PRIMARY);
-            }
-            
-            if(i > 0 || true) { // Always draw separator after visual editor tab
-                DrawLine(tab.x, tab.y, tab.x, tab.y + tab.height, BG_DARK);
-            }
-        }
-
-        // Enhanced Left panel with variables
-        DrawRectangle(0,tabBarH,(float)leftPanelW,(float)(screenH-bottomH-tabBarH),BG_MEDIUM);
-        DrawRectangle(leftPanelW-1,tabBarH,1,(float)(screenH-bottomH-tabBarH),BG_LIGHT);
-        
-        int yOffset = tabBarH+15;
-        DrawTextEx(customFont, "Objects:", (Vector2){15, yOffset}, 18, 0, TEXT_PRIMARY);
-        yOffset += 30;
-        
-        for(int i=0;i<objectCount && i<8;i++){  // Limit to 8 objects for space
-            Color objColor = objects[i].selected ? ACCENT_BLUE : TEXT_SECONDARY;
-            Rectangle objRect = {10, yOffset+i*25, leftPanelW-20, 22};
-            if(objects[i].selected) {
-                DrawRectangleRounded(objRect, 0.2f, 8, (Color){ACCENT_BLUE.r, ACCENT_BLUE.g, ACCENT_BLUE.b, 40});
-            }
-            DrawTextEx(customFont, objects[i].name, (Vector2){15, yOffset+5+i*25}, 16, 0, objColor);
-            
-            if(objects[i].shape == SHAPE_CIRCLE) {
-                DrawCircle(leftPanelW-25, yOffset+13+i*25, 6, objects[i].color);
-            } else {
-                DrawRectangle(leftPanelW-31, yOffset+7+i*25, 12, 12, objects[i].color);
-            }
-        }
-        
-        yOffset += objectCount * 25 + 20;
-        DrawTextEx(customFont, "Variables:", (Vector2){15, yOffset}, 18, 0, TEXT_PRIMARY);
-        yOffset += 25;
-        
-        for(int i=0;i<variableCount && i<6;i++){  // Limit to 6 variables for space
-            char varText[64];
-            snprintf(varText, sizeof(varText), "%s: %.1f", variables[i].name, variables[i].value);
-            DrawTextEx(customFont, varText, (Vector2){15, yOffset+i*18}, 14, 0, ACCENT_PURPLE);
-        }
-
-        // Enhanced Canvas
-        DrawRectangleRec(canvas,BG_MEDIUM);
-        DrawRectangleLinesEx(canvas, 1, BG_LIGHT);
-        
-        for(int i=0;i<objectCount;i++){
-            GameObject *o=&objects[i];
-            
-            if(o->selected) {
-                if(o->shape==SHAPE_CIRCLE) {
-                    DrawCircleLinesV(o->position, o->size + 5, ACCENT_BLUE);
-                } else {
-                    Vector2 topLeft = Vector2Subtract(o->position,(Vector2){o->size+5,o->size+5});
-                    DrawRectangleLinesEx((Rectangle){topLeft.x, topLeft.y, (o->size+5)*2, (o->size+5)*2}, 2, ACCENT_BLUE);
-                }
-            }
-            
-            if(o->shape==SHAPE_CIRCLE) {
-                DrawCircleV(o->position,(int)o->size,o->color);
-                DrawCircleLinesV(o->position,(int)o->size,DARKGRAY);
-            } else {
-                Vector2 topLeft = Vector2Subtract(o->position,(Vector2){o->size,o->size});
-                DrawRectangleV(topLeft, (Vector2){o->size*2,o->size*2}, o->color);
-                DrawRectangleLinesEx((Rectangle){topLeft.x, topLeft.y, o->size*2, o->size*2}, 1, DARKGRAY);
-            }
-
-            float tw = MeasureTextSubstring(o->name,strlen(o->name),12);
-            DrawRectangle((int)(o->position.x-tw/2-4),(int)(o->position.y-o->size-20), tw+8, 16, (Color){0,0,0,150});
-            DrawTextEx(customFont, o->name, (Vector2){(int)(o->position.x-tw/2), (int)(o->position.y-o->size-18)}, 12, 0, WHITE);
-        }
-
-        // Enhanced Bottom command bar
-        Rectangle cmdRect={0,(float)(screenH-commandBarH),(float)screenW,(float)commandBarH};
-        DrawRectangleRec(cmdRect,BG_DARK);
-        DrawRectangle(0, screenH-commandBarH, screenW, 1, BG_LIGHT);
-        
-        DrawTextEx(customFont, "> ", (Vector2){10, (int)(screenH-commandBarH)+10}, 20, 0, ACCENT_BLUE);
-        DrawTextEx(customFont, commandBuffer, (Vector2){35, (int)(screenH-commandBarH)+10}, 20, 0, TEXT_PRIMARY);
-        
-        static float cursorTimer = 0;
-        cursorTimer += GetFrameTime();
-        if(cursorTimer < 0.5f) {
-            float textWidth = MeasureText(commandBuffer, 20);
-            DrawTextEx(customFont, "_", (Vector2){35 + textWidth, (int)(screenH-commandBarH)+10}, 20, 0, ACCENT_BLUE);
-        }
-        if(cursorTimer > 1.0f) cursorTimer = 0;
-
-        // Enhanced Logs
-        DrawRectangle(0, screenH-commandBarH-logBarH, screenW, logBarH, BG_MEDIUM);
-        DrawRectangle(0, screenH-commandBarH-logBarH, screenW, 1, BG_LIGHT);
-        
-        for(int i=0;i<logCount;i++) {
-            Color logColor = TEXT_SECONDARY;
-            if(strstr(logs[i], "Error:")) logColor = ACCENT_RED;
-            else if(strstr(logs[i], "Added") || strstr(logs[i], "Loaded") || strstr(logs[i], "Saved") || strstr(logs[i], "Executed")) logColor = ACCENT_GREEN;
-            else if(strstr(logs[i], "[Script]") || strstr(logs[i], "[Python]")) logColor = ACCENT_PURPLE;
-            
-            DrawTextEx(customFont, logs[i], (Vector2){15, (int)(screenH-commandBarH-logBarH+10+i*20)}, 14, 0, logColor);
-        }
-
-        // Enhanced Play button
-        DrawRectangleRounded(playButton, 0.2f, 8, running ? ACCENT_GREEN : ACCENT_RED);
-        const char* buttonText = running ? "▪ Stop" : "▶ Run";
-        DrawTextEx(customFont, buttonText, (Vector2){(int)playButton.x+15, (int)playButton.y+10}, 18, 0, WHITE);
-
-        // Enhanced Script editor with syntax highlighting
-        if(activeEditor>=0){
-            ScriptEditor *ed=&openEditors[activeEditor];
-            int startY=tabBarH; int startX=leftPanelW;
-            Rectangle editorRect = {startX, startY, (float)(screenW-leftPanelW), (float)(screenH-bottomH-tabBarH)};
-            
-            DrawRectangleRec(editorRect, BG_DARK);
-            
-            // Draw line numbers background
-            DrawRectangle(startX, startY, 50, editorRect.height, BG_MEDIUM);
-            DrawLine(startX+50, startY, startX+50, startY+editorRect.height, BG_LIGHT);
-            
-            // Show Script status
-            if(ed->isPython) {
-                DrawTextEx(customFont, "Python Script - Press F5 to Run", (Vector2){startX + 60, startY + 5}, 12, 0, ACCENT_GREEN);
-            } else if(ed->isScript) {
-                DrawTextEx(customFont, "Custom Script - Press F5 to Run", (Vector2){startX + 60, startY + 5}, 12, 0, ACCENT_PURPLE);
-            }
-            
-            // Draw editor content with syntax highlighting
-            int contentStartY = startY + ((ed->isPython || ed->isScript) ? 25 : 10);
-            for(int i=0;i<VISIBLE_LINES && i+ed->scroll < ed->lineCount;i++){
-                int lineIdx=i+ed->scroll;
-                int lineY = contentStartY + i*editorCharY;
-                
-                // Line number
-                char lineNum[8];
-                snprintf(lineNum, sizeof(lineNum), "%d", lineIdx + 1);
-                DrawTextEx(customFont, lineNum, (Vector2){startX + 10, lineY}, 14, 0, TEXT_SECONDARY);
-                
-                // Line content
-                if(strlen(ed->lines[lineIdx]) > 0) {
-                    if(ed->isPython) {
-                                                // Draw the whole line first
-                        DrawTextEx(customFont, ed->lines[lineIdx], (Vector2){startX + 60, lineY}, 14, 0, TEXT_PRIMARY);
-                        
-                        // Python keywords
-                        const char* keywords[] = {
-                            "and", "assert", "break", "class", "continue", "def",
-                            "del", "elif", "else", "except", "exec", "finally",
-                            "for", "from", "global", "if", "import", "in",
-                            "is", "lambda", "not", "or", "pass", "print",
-                            "raise", "return", "try", "while", "yield",
-                            "None", "True", "False"
-                        };
-                        int keywordCount = sizeof(keywords) / sizeof(keywords[0]);
-                        
-                        // Built-in functions
-                        const char* builtins[] = {"len", "range", "str", "int", "float", "list", "dict", "open", "abs", "min", "max"};
-                        int builtinCount = sizeof(builtins) / sizeof(builtins[0]);
-                        
-                        // Game API functions
-                        const char* gameAPI[] = {"move_object", "set_position", "set_color", "create_circle", "create_rect", "log_message"};
-                        int gameAPICount = sizeof(gameAPI) / sizeof(gameAPI[0]);
-                        
-                        char *line = ed->lines[lineIdx];
-                        
-                        // Highlight keywords
-                        for(int k = 0; k < keywordCount; k++) {
-                            char *pos = strstr(line, keywords[k]);
-                            while(pos != NULL) {
-                                // Make sure it's a whole word (not part of another word)
-                                bool isWholeWord = (pos == line || !isalnum(*(pos-1))) && 
-                                                  (!isalnum(pos[strlen(keywords[k])]));
-                                
-                                if(isWholeWord) {
-                                    int charOffset = pos - line;
-                                    float xOffset = MeasureTextEx(customFont, line, 14, 0).x * charOffset / strlen(line);
-                                    DrawTextEx(customFont, keywords[k], (Vector2){startX + 60 + xOffset, lineY}, 14, 0, ACCENT_BLUE);
-                                }
-                                pos = strstr(pos + 1, keywords[k]);
-                            }
-                        }
-                        
-                        // Highlight built-ins
-                        for(int b = 0; b < builtinCount; b++) {
-                            char *pos = strstr(line, builtins[b]);
-                            while(pos != NULL) {
-                                bool isWholeWord = (pos == line || !isalnum(*(pos-1))) && 
-                                                  (!isalnum(pos[strlen(builtins[b])]));
-                                
-                                if(isWholeWord) {
-                                    int charOffset = pos - line;
-                                    float xOffset = MeasureTextEx(customFont, line, 14, 0).x * charOffset / strlen(line);
-                                    DrawTextEx(customFont, builtins[b], (Vector2){startX + 60 + xOffset, lineY}, 14, 0, ACCENT_PURPLE);
-                                }
-                                pos = strstr(pos + 1, builtins[b]);
-                            }
-                        }
-                        
-                        // Highlight game API
-                        for(int g = 0; g < gameAPICount; g++) {
-                            char *pos = strstr(line, gameAPI[g]);
-                            while(pos != NULL) {
-                                bool isWholeWord = (pos == line || !isalnum(*(pos-1))) && 
-                                                  (!isalnum(pos[strlen(gameAPI[g])]));
-                                
-                                if(isWholeWord) {
-                                    int charOffset = pos - line;
-                                    float xOffset = MeasureTextEx(customFont, line, 14, 0).x * charOffset / strlen(line);
-                                    DrawTextEx(customFont, gameAPI[g], (Vector2){startX + 60 + xOffset, lineY}, 14, 0, ACCENT_GREEN);
-                                }
-                                pos = strstr(pos + 1, gameAPI[g]);
-                            }
-                        }
-                                                // Highlight numbers (yellow/orange)
-                        char *linePtr = line;
-                        while(*linePtr) {
-                            if(isdigit(*linePtr) || (*linePtr == '.' && isdigit(*(linePtr+1)))) {
-                                // Found start of a number
-                                char *numStart = linePtr;
-                                
-                                // Find end of number (including decimals)
-                                while(isdigit(*linePtr) || *linePtr == '.') {
-                                    linePtr++;
-                                }
-                                
-                                // Extract the number
-                                int numLen = linePtr - numStart;
-                                char numberStr[32];
-                                strncpy(numberStr, numStart, numLen);
-                                numberStr[numLen] = '\0';
-                                
-                                // Calculate position and draw
-                                int charOffset = numStart - line;
-                                float xOffset = MeasureTextEx(customFont, line, 14, 0).x * charOffset / strlen(line);
-                                DrawTextEx(customFont, numberStr, (Vector2){startX + 60 + xOffset, lineY}, 14, 0, ACCENT_ORANGE);
-                            } else {
-                                linePtr++;
-                            }
-                        }
-
-                        // Highlight operators (green)
-                        const char* operators[] = {
-                            "==", "!=", "<=", ">=", "+=", "-=", "*=", "/=", "%=", 
-                            "//", "**", "<<", ">>", "=", "<", ">", "+", "-", "*", 
-                            "/", "%", "&", "|", "^", "~"
-                        };
-                        int operatorCount = sizeof(operators) / sizeof(operators[0]);
-
-                        for(int o = 0; o < operatorCount; o++) {
-                            char *pos = strstr(line, operators[o]);
-                            while(pos != NULL) {
-                                // Make sure it's not part of a larger operator
-                                bool validOp = true;
-                                if(strlen(operators[o]) == 1) {
-                                    // For single-char operators, check they're not part of multi-char ones
-                                    char prev = (pos > line) ? *(pos-1) : ' ';
-                                    char next = *(pos+1);
-                                    if((prev == '=' || prev == '!' || prev == '<' || prev == '>') ||
-                                       (next == '=' || (operators[o][0] == '*' && next == '*'))) {
-                                        validOp = false;
-                                    }
-                                }
-                                
-                                if(validOp) {
-                                    int charOffset = pos - line;
-                                    float xOffset = MeasureTextEx(customFont, line, 14, 0).x * charOffset / strlen(line);
-                                    DrawTextEx(customFont, operators[o], (Vector2){startX + 60 + xOffset, lineY}, 14, 0, ACCENT_GREEN);
-                                }
-                                pos = strstr(pos + 1, operators[o]);
-                            }
-                        }
-                    } else if(ed->isScript) {
-                        // Custom script syntax highlighting
-                        char *line = ed->lines[lineIdx];
-                        int x = startX + 60;
-                        char word[64] = {0};
-                        int wordIdx = 0;
-                        
-                        for(int c = 0; line[c]; c++) {
-                            if(isalnum(line[c]) || line[c] == '_') {
-                                word[wordIdx++] = line[c];
-                            } else {
-                                if(wordIdx > 0) {
-                                    word[wordIdx] = '\0';
-                                    Color tokenColor = GetScriptTokenColor(word);
-                                    DrawTextEx(customFont, word, (Vector2){x, lineY}, 14, 0, tokenColor);
-                                    x += MeasureTextEx(customFont, word, 14, 0).x;
-                                    wordIdx = 0;
-                                }
-                                char charStr[2] = {line[c], '\0'};
-                                Color charColor = TEXT_PRIMARY;
-                                if(line[c] == '=' || line[c] == '+' || line[c] == '-' || line[c] == '*' || line[c] == '/') {
-                                    charColor = ACCENT_ORANGE;
-                                } else if(line[c] == '"') {
-                                    charColor = ACCENT_GREEN;
-                                }
-                                DrawTextEx(customFont, charStr, (Vector2){x, lineY}, 14, 0, charColor);
-                                x += MeasureTextEx(customFont, charStr, 14, 0).x;
-                            }
-                        }
-                        
-                        if(wordIdx > 0) {
-                            word[wordIdx] = '\0';
-                            Color tokenColor = GetScriptTokenColor(word);
-                            DrawTextEx(customFont, word, (Vector2){x, lineY}, 14, 0, tokenColor);
-                        }
-                    } else {
-                        DrawTextEx(customFont, ed->lines[lineIdx], (Vector2){startX + 60, lineY}, 14, 0, TEXT_PRIMARY);
-                    }
-                }
-            }
-            
-            // Enhanced Caret
-            if(caretLine >= ed->scroll && caretLine < ed->scroll + VISIBLE_LINES) {
-                int caretX = startX + 60 + (int)MeasureTextSubstring(ed->lines[caretLine], caretCol, 14);
-                int caretY = contentStartY + (caretLine - ed->scroll) * editorCharY;
-                
-                static float caretBlink = 0;
-                caretBlink += GetFrameTime();
-                if(caretBlink < 0.5f) {
-                    DrawLine(caretX, caretY, caretX, caretY + editorCharY - 2, ACCENT_BLUE);
-                }
-                if(caretBlink > 1.0f) caretBlink = 0;
-            }
-            
-            // Current line highlight
-            if(caretLine >= ed->scroll && caretLine < ed->scroll + VISIBLE_LINES) {
-                int highlightY = contentStartY + (caretLine - ed->scroll) * editorCharY;
-                DrawRectangle(startX + 50, highlightY - 2, screenW - leftPanelW - 50, editorCharY, (Color){ACCENT_BLUE.r, ACCENT_BLUE.g, ACCENT_BLUE.b, 20});
-            }
-        }
-
-        // Help text
-        DrawTextEx(customFont, "Commands: NewScript/NewPython <n>, RunScript/RunPython <n>, set var value", (Vector2){10, screenH-15}, 10, 0, TEXT_SECONDARY);
-
-        EndDrawing();
-    }
-
-    Py_Finalize();
-    CloseWindow();
-    return 0;
+#include <raylib.h>
+#include "raymath.h"
+#include "rlgl.h"
+#include <Python.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <math.h>
+#include <ctype.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#define MakeDir(path) _mkdir(path)
+#else
+#define MakeDir(path) mkdir(path, 0755)
+#endif
+
+#define HANDLE_SLOT_BITS 22
+#define MAX_OBJECTS ((1<<HANDLE_SLOT_BITS)-1)
+#define NAME_LEN    32
+#define SCENE_VERSION 1
+#define JOURNAL_VERSION 1
+#define JOURNAL_FLUSH_INTERVAL 1.0     // Seconds between writes of queued journal changes
+#define JOURNAL_COMPACT_MIN 4096       // Records before the journal may be folded into main.scene
+#define LOG_RING_CAP 4096           // Power of two; oldest entries are overwritten
+#define LOG_VISIBLE  3              // Lines shown in the log bar
+#define LOG_FILE_MAX_BYTES (1<<20)  // engine.log rotates to engine.1.log past this
+#define LOG_FILE_KEEP 3             // Rotated files kept per project
+#define CMD_LEN     256
+#define MAX_SUGGESTIONS 64
+#define SCRIPT_POLL_MS 500          // Scripts folder rescan period where inotify is unavailable
+#define LINE_LEN    128
+#define VISIBLE_LINES 20
+#define SIM_TICK_RATE 60
+#define HEADLESS_DEFAULT_TICKS 600
+#define HEADLESS_CANVAS ((Rectangle){220, 35, 980, 725}) // Canvas of the default 1200x800 window
+#define GRID_CELL 128.0f            // Spatial grid cell size; bigger objects live in a side list
+#define GRID_LARGE (-2)             // gridCell value for objects in the side list
+
+typedef enum { SHAPE_CIRCLE=0, SHAPE_RECT=1 } ShapeType;
+
+// Stable object id that survives other objects being deleted; 0 is "none".
+// Low bits are slot+1, high bits a generation bumped on every delete, so a
+// stale handle never resolves to whatever reused the slot.
+// Scripts and Python can cache it and refer to the object as "#<handle>".
+typedef unsigned int ObjectHandle;
+#define INVALID_HANDLE 0
+#define HANDLE_SLOT_MASK ((1u<<HANDLE_SLOT_BITS)-1)
+
+// Structure-of-arrays object store: columns are dense over [0, count) and
+// deletes swap the last object into the hole, so loops stream only the
+// columns they read. Handles map to dense indices through the slot table.
+typedef struct {
+    int count, capacity;
+    Vector2* position;
+    Vector2* previous;      // Position before the current tick, for render interpolation
+    Vector2* velocity;      // Units per second, integrated every tick
+    Vector2* acceleration;  // Units per second squared
+    float* damping;         // Fraction of velocity shed per second, roughly; 0 = none
+    float* size;
+    Color* color;
+    unsigned char* shape;   // ShapeType
+    bool* selected;
+    char (*name)[NAME_LEN];
+    unsigned int* nameHash;
+    ObjectHandle* handle;
+    unsigned char* dirty;        // 1 while the object sits in dirtyList
+    unsigned char* journalPending; // 1 while the object sits in journal.pending
+    float* labelWidth;           // Cached name width at LABEL_FONT_SIZE
+    unsigned int* labelEpoch;    // fontEpoch the width was measured with, 0 = never
+    int* gridCell;               // Spatial grid cell, GRID_LARGE, or -1 when unlinked
+    int* gridNext;               // Intrusive per-cell list of dense indices
+    int* gridPrev;
+
+    // Objects changed in bulk (Python views + commit) since the last apply
+    ObjectHandle* dirtyList;
+    int dirtyCount, dirtyCapacity;
+    int viewExports;             // Live Python buffer views; columns must not move
+    unsigned int version;        // Bumped whenever a batch of changes is applied
+    bool moving;                 // Some object may have velocity or acceleration
+    bool motionUnsaved;          // Integrated positions aren't journaled; the next save snapshots
+
+    int* slotIndex;              // slot -> dense index, -1 when free
+    unsigned short* slotGeneration;
+    int* freeSlots;
+    int slotCount, slotCapacity, freeSlotCount;
+} ObjectStore;
+
+// Uniform grid bucket keyed by cell coordinates. Objects are filed by their
+// center, so anything of size <= GRID_CELL overlapping a point lies in the
+// 3x3 cells around it. A cell is removed as soon as its last object leaves,
+// so the table tracks the occupied area rather than everywhere ever visited.
+typedef struct {
+    int cx, cy;
+    int head;     // First object in the cell, -1 when empty
+    bool used;
+} GridCell;
+
+typedef struct {
+    GridCell* cells;
+    int capacity, used;  // Open addressing, kept at most half full
+    int largeHead;       // Objects with size > GRID_CELL
+} SpatialGrid;
+
+typedef enum { VAR_FLOAT=0, VAR_INT=1, VAR_VEC2=2, VAR_COLOR=3 } VarType;
+
+// Interned variable: slots are never reused, so compiled code, the
+// console and Python can bind a slot once and index variables[] directly
+typedef struct {
+    char name[NAME_LEN];
+    unsigned int nameHash;
+    unsigned char type;     // VarType
+    bool defined;           // false while only referenced, never assigned
+    bool journalPending;    // Queued in journal.pendingVariables
+    union {
+        float f;
+        int i;
+        Vector2 v;
+        Color c;
+    } value;
+} Variable;
+
+// Project journal: main.journal holds the changes made since main.scene was
+// written, as fixed-size records appended in order. Adds and deletes are
+// written as they happen; moves, recolors and variable sets are queued and
+// written as one record per object/variable per flush.
+typedef enum { JOURNAL_ADD=1, JOURNAL_DELETE, JOURNAL_UPDATE, JOURNAL_VARIABLE } JournalOp;
+
+typedef struct {
+    char magic[4];                 // "2DJR"
+    unsigned int version;          // JOURNAL_VERSION
+    unsigned long long sequence;   // SceneHeader.journalSequence this journal applies to
+} JournalHeader;
+
+typedef struct {
+    unsigned int checksum;         // HashBytes of the rest; a torn write fails it
+    unsigned char op;              // JournalOp
+    unsigned char kind;            // ShapeType (ADD) or VarType (VARIABLE)
+    unsigned char reserved[2];
+    char name[NAME_LEN];
+    Vector2 position;              // ADD, UPDATE
+    float size;
+    Color color;
+    unsigned char value[8];        // VARIABLE: raw Variable.value
+} JournalRecord;
+
+typedef struct {
+    FILE* file;                    // NULL while no saved project is open
+    unsigned long long sequence;
+    long records;                  // Records since the snapshot
+    bool unsynced;                 // Written since the last fsync
+    double lastFlush;
+    ObjectHandle* pending;
+    int pendingCount, pendingCapacity;
+    int* pendingVariables;
+    int pendingVariableCount, pendingVariableCapacity;
+} Journal;
+
+// Owner of a heap block, for the per-subsystem counters in the Memory section
+typedef enum {
+    MEM_OBJECTS, MEM_NAMES, MEM_GRID, MEM_VARIABLES, MEM_JOURNAL, MEM_COLLISION,
+    MEM_SCRIPTS, MEM_PROGRAMS, MEM_EDITOR, MEM_PYTHON, MEM_RENDER, MEM_JOBS, MEM_PROFILER, MEM_IO,
+    MEM_COUNT
+} MemTag;
+
+// Bump allocator; pieces are only freed all at once (see ArenaAlloc)
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t used, size;
+    max_align_t data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock* head;               // Newest block; allocations come from here
+    MemTag tag;
+    size_t used;                    // Handed out, including abandoned pieces
+    void* last;                     // Most recent allocation, which ArenaGrow can extend in place
+    size_t lastSize;
+} Arena;
+
+// --- Compiled scripts ---
+// Script lines are compiled once (on load/save) into a flat instruction
+// stream; the VM then only evaluates operands, never re-parses text.
+typedef enum {
+    OP_ASSIGN,          // name = args[0]
+    OP_MOVE,            // object += (args[0], args[1])
+    OP_SET_POS,         // object = (args[0], args[1])
+    OP_SET_COLOR,       // object color = (args[0..2])
+    OP_CREATE_CIRCLE,   // name x y size r g b
+    OP_CREATE_RECT,
+    OP_LOG,             // name = message text
+    OP_FOR,
+    OP_SET_VELOCITY,    // object velocity = (args[0], args[1])
+    OP_SET_ACCEL,       // object acceleration = (args[0], args[1])
+    OP_SET_DAMPING      // object damping = args[0]
+} OpCode;
+
+// Expressions compile to postfix code for a small stack machine
+typedef enum {
+    EX_CONST, EX_VAR, EX_TIME,
+    EX_ADD, EX_SUB, EX_MUL, EX_DIV, EX_NEG,
+    EX_SIN, EX_COS, EX_SQRT, EX_ABS,
+    EX_MIN, EX_MAX, EX_ATAN2,
+    EX_OBJECT,                      // Dense index of the object named at strings+slot, or -1
+    EX_TOUCHING, EX_COLLIDED, EX_CONTACTS, EX_COLLISIONS
+} ExprOp;
+
+#define EXPR_STACK 32
+
+typedef struct {
+    unsigned char op;
+    int slot;       // variables[] slot bound at compile time (EX_VAR)
+    unsigned char component; // 0 whole value, 1-4 = .x/.r .y/.g .b .a
+    float value;    // EX_CONST
+} ExprNode;
+
+// An operand: a range of ExprNodes in the owning program
+typedef struct {
+    int first;
+    int count;
+} ScriptArg;
+
+typedef struct {
+    unsigned char op;
+    unsigned char argCount;
+    int firstArg;           // index into ScriptProgram.args
+    int name;               // string pool offset: object, variable or log text
+    ObjectHandle object;    // cached target, re-resolved by name when stale
+    int slot;               // variables[] slot for OP_ASSIGN
+    unsigned char component; // assigned component, as in ExprNode
+} Instruction;
+
+typedef struct {
+    Instruction* code;
+    int count, capacity;
+    ScriptArg* args;
+    int argCount, argCapacity;
+    ExprNode* nodes;
+    int nodeCount, nodeCapacity;
+    char* strings;
+    int stringsLen, stringsCap;
+} ScriptProgram;
+
+// Highlighting of one editor line, rebuilt only after the line is edited:
+// colored spans plus the x offset of every character at EDITOR_FONT_SIZE
+typedef struct {
+    int start, len;
+    Color color;
+} TokenSpan;
+
+typedef struct {
+    bool valid;
+    unsigned int fontEpoch;
+    Arena* arena;                // The owning buffer's layout arena
+    TokenSpan* spans;
+    int spanCount, spanCapacity;
+    float* advance;              // advance[i] = x of character i; advance[len] = line width
+    int advanceCapacity;
+} LineLayout;
+
+typedef struct {
+    char* text;                  // NUL-terminated, NULL while empty; lives in the buffer's text arena
+    int len, capacity;
+    LineLayout* layout;          // Allocated the first time the line is drawn
+} TextLine;
+
+// Lines of one file in a gap buffer: [0, gapStart) and [gapEnd, capacity)
+// hold lines, so inserting or deleting at the caret is O(1) amortized.
+// Reference counted: a Script and the editors showing it share one buffer.
+// Line text and highlighting come from two arenas the buffer owns: a loaded
+// file is one block its lines point into, a line that outgrows its space
+// moves to a new piece, and releasing the buffer frees both arenas whole.
+typedef struct {
+    TextLine* lines;
+    int capacity, gapStart, gapEnd;
+    int refs;
+    Arena text;                  // MEM_SCRIPTS
+    Arena layout;                // MEM_EDITOR; stays empty until a tab draws the buffer
+} TextBuffer;
+
+typedef struct {
+    char name[NAME_LEN];
+    TextBuffer* text;
+    bool isScript;  // True for our custom scripting language
+    bool isPython;  // True for Python scripts
+    ScriptProgram program;
+} Script;
+
+typedef struct {
+    char name[NAME_LEN];
+    TextBuffer* text;   // Shared with the Script of the same name once saved or loaded
+    int scroll;
+    bool isScript;
+    bool isPython;
+    bool modified;      // Edited since opened, saved or reloaded from disk
+} ScriptEditor;
+
+// Global variables for scripting
+static Variable* variables = NULL;
+static int variableCount = 0, variableCapacity = 0;
+// Name -> slot+1, open addressing (0 = empty), kept at most half full
+static int* variableIndex = NULL;
+static int variableIndexCap = 0;
+static bool scriptRunning = false;
+static int currentScriptLine = 0;
+
+static ObjectStore objects = {0};
+static SpatialGrid grid = { NULL, 0, 0, -1 };
+static Journal journal = {0};
+
+// Name -> handle, open addressing with linear probing (0 = empty bucket),
+// grown so it never gets more than half full
+static ObjectHandle* nameIndex = NULL;
+static int nameIndexCap = 0;
+
+static Script* scripts = NULL;
+static int scriptCount = 0, scriptCapacity = 0;
+
+static ScriptEditor* openEditors = NULL;
+static int openCount = 0, openCapacity = 0;
+static int activeEditor = -1;
+static int caretLine=0, caretCol=0;
+
+static bool visualEditorOpen = false;
+static int selectedObject = -1; // For visual editor
+
+static char commandBuffer[CMD_LEN] = {0};
+static int commandLen = 0;
+static int logScroll = 0; // Lines scrolled back from the newest entry
+static bool running = false;
+static bool headless = false;
+static bool dragging = false;
+static Vector2 dragOffset = {0};
+
+// --- Auto-suggest ---
+static char suggestions[MAX_SUGGESTIONS][NAME_LEN];
+static int suggestionCount = 0;
+static int highlightedSuggestion = -1;
+
+// Color scheme
+static const Color BG_DARK = {25, 25, 30, 255};
+static const Color BG_MEDIUM = {35, 35, 40, 255};
+static const Color BG_LIGHT = {45, 45, 50, 255};
+static const Color ACCENT_BLUE = {64, 128, 255, 255};
+static const Color ACCENT_GREEN = {64, 255, 128, 255};
+static const Color ACCENT_RED = {255, 64, 64, 255};
+static const Color ACCENT_ORANGE = {255, 165, 0, 255};
+static const Color ACCENT_PURPLE = {160, 64, 255, 255};
+static const Color TEXT_PRIMARY = {255, 255, 255, 255};
+static const Color TEXT_SECONDARY = {200, 200, 200, 255};
+
+// Forward declarations
+static void ExecuteCommand(const char* cmd);
+static void CompileScript(Script* script);
+static void FreeProgram(ScriptProgram* p);
+static void SetVariable(const char* name, float value);
+static char currentProject[NAME_LEN] = "Default"; // Active project name
+
+
+// Measure width of first 'n' characters of a string using Raylib font
+float MeasureTextSubstring(const char *text, int n, int fontSize){
+    Font font = GetFontDefault();
+    char tmp[LINE_LEN] = {0};
+    strncpy(tmp, text, n);
+    tmp[n] = '\0';
+    return MeasureTextEx(font, tmp, (float)fontSize, 0).x;
+}
+
+// --- Timing ---
+// Monotonic wall clock in seconds; usable before (or without) InitWindow
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// --- Memory ---
+// Every heap block the engine allocates is tagged with the subsystem that
+// owns it, and a small header (32 bytes on x86-64) keeps size and tag so
+// MemFree can take it off that subsystem's counter; `mem` prints the
+// totals. Python's and raylib's own allocations aren't counted.
+static const char* memTagNames[MEM_COUNT] = {
+    "objects", "name index", "grid", "variables", "journal", "collisions",
+    "script text", "programs", "editor", "python", "render", "jobs", "profiler", "file io"
+};
+
+typedef union {
+    struct { size_t size; MemTag tag; } h;
+    max_align_t align;              // Keeps the block after the header malloc-aligned
+} MemHeader;
+
+static atomic_llong memBytes[MEM_COUNT];
+static atomic_llong memBlocks[MEM_COUNT];
+static atomic_llong memArenaUsed[MEM_COUNT]; // Bytes handed out by arenas, within memBytes
+
+static void MemCount(MemTag tag, long long bytes, long long blocks){
+    atomic_fetch_add_explicit(&memBytes[tag], bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&memBlocks[tag], blocks, memory_order_relaxed);
+}
+
+static void* MemAlloc(MemTag tag, size_t size){
+    MemHeader* m = malloc(sizeof(MemHeader) + size);
+    if(!m) return NULL;
+    m->h.size = size; m->h.tag = tag;
+    MemCount(tag, (long long)size, 1);
+    return m + 1;
+}
+
+static void* MemCalloc(MemTag tag, size_t count, size_t size){
+    if(size && count > (SIZE_MAX - sizeof(MemHeader)) / size) return NULL;
+    void* p = MemAlloc(tag, count * size);
+    if(p) memset(p, 0, count * size);
+    return p;
+}
+
+// A NULL block is allocated under tag; an existing one keeps its own tag
+static void* MemRealloc(MemTag tag, void* p, size_t size){
+    if(!p) return MemAlloc(tag, size);
+    MemHeader* m = (MemHeader*)p - 1;
+    size_t old = m->h.size;
+    MemHeader* grown = realloc(m, sizeof(MemHeader) + size);
+    if(!grown) return NULL;
+    grown->h.size = size;
+    MemCount(grown->h.tag, (long long)size - (long long)old, 0);
+    return grown + 1;
+}
+
+static void MemFree(void* p){
+    if(!p) return;
+    MemHeader* m = (MemHeader*)p - 1;
+    MemCount(m->h.tag, -(long long)m->h.size, -1);
+    free(m);
+}
+
+// Bump allocator for data that dies together: blocks are only ever freed
+// all at once by ArenaFree, so allocating is a pointer bump and dropping
+// thousands of small pieces is a handful of frees. Not thread-safe; one
+// owner at a time.
+#define ARENA_MIN_BLOCK 4096
+#define ARENA_MAX_BLOCK (64*1024)
+#define ARENA_ALIGN (sizeof(max_align_t))
+#define ArenaRound(n) (((n) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+static void* ArenaAlloc(Arena* a, size_t size){
+    size = ArenaRound(size ? size : 1);
+    ArenaBlock* b = a->head;
+    if(!b || b->size - b->used < size){
+        // The first block fits the first request exactly (a loaded file, say);
+        // later ones double from ARENA_MIN_BLOCK, and oversized requests get their own
+        size_t blockSize = b ? b->size * 2 : size;
+        if(b && blockSize < ARENA_MIN_BLOCK) blockSize = ARENA_MIN_BLOCK;
+        if(blockSize > ARENA_MAX_BLOCK) blockSize = ARENA_MAX_BLOCK;
+        if(blockSize < size) blockSize = size;
+        if(!(b = MemAlloc(a->tag, sizeof(ArenaBlock) + blockSize))) return NULL;
+        b->used = 0; b->size = blockSize;
+        b->next = a->head; a->head = b;
+    }
+    void* p = (char*)b->data + b->used;
+    b->used += size;
+    a->used += size;
+    atomic_fetch_add_explicit(&memArenaUsed[a->tag], (long long)size, memory_order_relaxed);
+    a->lastSize = size;
+    return a->last = p;
+}
+
+// Resizes an arena allocation: in place when it is the latest one and the
+// block has room, otherwise by copying into a new piece (the old one stays
+// allocated until ArenaFree)
+static void* ArenaGrow(Arena* a, void* p, size_t oldSize, size_t size){
+    if(!p) return ArenaAlloc(a, size);
+    oldSize = ArenaRound(oldSize); size = ArenaRound(size);
+    ArenaBlock* b = a->head;
+    if(p == a->last && oldSize == a->lastSize && b->size - (b->used - oldSize) >= size){
+        b->used += size - oldSize;
+        a->used += size - oldSize;
+        atomic_fetch_add_explicit(&memArenaUsed[a->tag], (long long)size - (long long)oldSize, memory_order_relaxed);
+        a->lastSize = size;
+        return p;
+    }
+    void* q = ArenaAlloc(a, size);
+    if(q) memcpy(q, p, oldSize < size ? oldSize : size);
+    return q;
+}
+
+static void FormatBytes(long long bytes, char* out, size_t size){
+    if(bytes >= 1024*1024) snprintf(out, size, "%.1f MB", bytes / (1024.0*1024.0));
+    else if(bytes >= 1024) snprintf(out, size, "%.1f KB", bytes / 1024.0);
+    else snprintf(out, size, "%lld B", bytes);
+}
+
+static long long MemTotal(void){
+    long long total = 0;
+    for(int t = 0; t < MEM_COUNT; t++) total += atomic_load_explicit(&memBytes[t], memory_order_relaxed);
+    return total;
+}
+
+static void ArenaFree(Arena* a){
+    atomic_fetch_sub_explicit(&memArenaUsed[a->tag], (long long)a->used, memory_order_relaxed);
+    for(ArenaBlock* b = a->head; b;){ ArenaBlock* next = b->next; MemFree(b); b = next; }
+    a->head = NULL; a->used = 0; a->last = NULL; a->lastSize = 0;
+}
+
+// --- Profiler ---
+// Scoped timing zones around the phases of a frame and a tick. Each zone
+// keeps its last PROFILE_SAMPLES durations for the overlay, and every thread
+// that opens zones gets a ring of finished events for `profile dump`.
+// ProfileBegin/ProfileEnd nest per thread; PROFILE_SCOPE closes its zone
+// when the enclosing block exits.
+#define PROFILE_SAMPLES 240         // Per-zone durations the overlay averages over
+#define PROFILE_EVENTS (1<<14)      // Per-thread trace ring, power of two
+#define PROFILE_MAX_THREADS 8
+#define PROFILE_MAX_DEPTH 32
+
+typedef enum {
+    PZ_FRAME, PZ_LOCK_WAIT, PZ_INPUT, PZ_SUGGEST, PZ_DRAG,
+    PZ_TICK, PZ_SCRIPTS, PZ_ANGLE, PZ_PYTHON, PZ_MOTION, PZ_COLLISIONS, PZ_SCENE_FRAME,
+    PZ_COMMAND, PZ_EXEC_SCRIPT, PZ_EXEC_PYTHON,
+    PZ_DRAW, PZ_DRAW_TABS, PZ_DRAW_PANEL, PZ_DRAW_CANVAS, PZ_DRAW_LABELS, PZ_DRAW_CONSOLE,
+    PZ_DRAW_EDITOR, PZ_HIGHLIGHT, PZ_PRESENT,
+    PZ_COUNT
+} ProfileZone;
+
+static const struct { const char* name; int indent; } profileZones[PZ_COUNT] = {
+    [PZ_FRAME]={"Frame",0},          [PZ_LOCK_WAIT]={"World lock",1}, [PZ_INPUT]={"Input",1},
+    [PZ_SUGGEST]={"Auto-suggest",1}, [PZ_DRAG]={"Dragging",1},
+    [PZ_TICK]={"Tick",0},            [PZ_SCRIPTS]={"Scripts",1},       [PZ_ANGLE]={"Angle update",1},
+    [PZ_PYTHON]={"Python",1},        [PZ_MOTION]={"Motion",1},         [PZ_COLLISIONS]={"Collisions",1},
+    [PZ_SCENE_FRAME]={"Scene frame",0},
+    [PZ_COMMAND]={"ExecuteCommand",0}, [PZ_EXEC_SCRIPT]={"ExecuteScript",0}, [PZ_EXEC_PYTHON]={"ExecutePythonScript",0},
+    [PZ_DRAW]={"Draw",1},            [PZ_DRAW_TABS]={"Tabs",2},        [PZ_DRAW_PANEL]={"Panel",2},
+    [PZ_DRAW_CANVAS]={"Canvas",2},   [PZ_DRAW_LABELS]={"Labels",2},    [PZ_DRAW_CONSOLE]={"Console",2},
+    [PZ_DRAW_EDITOR]={"Editor",2},   [PZ_HIGHLIGHT]={"Highlighting",3}, [PZ_PRESENT]={"Present",1},
+};
+
+typedef struct {
+    double start;
+    float duration;
+    int zone;
+} ProfileEvent;
+
+typedef struct {
+    char name[32];
+    int id;
+    struct { int zone; double start; } open[PROFILE_MAX_DEPTH];
+    int depth;                      // May exceed PROFILE_MAX_DEPTH; deeper zones aren't recorded
+    pthread_mutex_t lock;           // Guards events against a concurrent dump
+    ProfileEvent* events;
+    unsigned int eventCount;        // Total ever recorded; the ring holds the last PROFILE_EVENTS
+} ProfileThread;
+
+typedef struct {
+    atomic_uint samples[PROFILE_SAMPLES]; // Durations in ns, saturating
+    atomic_uint next;
+} ProfileZoneStats;
+
+static ProfileZoneStats profileStats[PZ_COUNT];
+static ProfileThread* profileThreads[PROFILE_MAX_THREADS];
+static int profileThreadCount = 0;
+static pthread_mutex_t profileThreadsLock = PTHREAD_MUTEX_INITIALIZER; // Guards the two above
+static _Thread_local ProfileThread* profileThread;
+static _Thread_local bool profileUnregistered; // The table was full when this thread asked
+static bool profileOverlay = false;
+
+// Name the calling thread in dumps; also registers it
+static ProfileThread* ProfileRegisterThread(const char* name){
+    if(profileThread || profileUnregistered) return profileThread;
+    ProfileThread* t = MemCalloc(MEM_PROFILER, 1, sizeof(ProfileThread));
+    if(t) t->events = MemAlloc(MEM_PROFILER, PROFILE_EVENTS * sizeof(ProfileEvent));
+    pthread_mutex_lock(&profileThreadsLock);
+    bool full = profileThreadCount >= PROFILE_MAX_THREADS;
+    if(t && t->events && !full){
+        t->id = profileThreadCount;
+        if(name) snprintf(t->name, sizeof(t->name), "%s", name);
+        else snprintf(t->name, sizeof(t->name), "thread %d", t->id);
+        pthread_mutex_init(&t->lock, NULL);
+        profileThreads[profileThreadCount++] = t;
+    }
+    pthread_mutex_unlock(&profileThreadsLock);
+    if(!t || !t->events || full){ if(t) MemFree(t->events); MemFree(t); profileUnregistered = true; return NULL; }
+    return profileThread = t;
+}
+
+static void ProfileBegin(int zone){
+    ProfileThread* t = profileThread ? profileThread : ProfileRegisterThread(NULL);
+    if(!t) return; // More threads than PROFILE_MAX_THREADS: not profiled
+    if(t->depth < PROFILE_MAX_DEPTH){ t->open[t->depth].zone = zone; t->open[t->depth].start = NowSeconds(); }
+    t->depth++;
+}
+
+static void ProfileEnd(void){
+    ProfileThread* t = profileThread;
+    if(!t || t->depth == 0) return;
+    if(--t->depth >= PROFILE_MAX_DEPTH) return;
+    double end = NowSeconds();
+    int zone = t->open[t->depth].zone;
+    double start = t->open[t->depth].start;
+    double ns = (end - start) * 1e9;
+    ProfileZoneStats* s = &profileStats[zone];
+    unsigned int slot = atomic_fetch_add_explicit(&s->next, 1, memory_order_relaxed) % PROFILE_SAMPLES;
+    atomic_store_explicit(&s->samples[slot], ns < 4e9 ? (unsigned int)ns : 4000000000u, memory_order_relaxed);
+    pthread_mutex_lock(&t->lock);
+    t->events[t->eventCount++ & (PROFILE_EVENTS-1)] = (ProfileEvent){ start, (float)(end - start), zone };
+    pthread_mutex_unlock(&t->lock);
+}
+
+#if defined(__GNUC__)
+static void ProfileScopeEnd(int* zone){ (void)zone; ProfileEnd(); }
+#define PROFILE_SCOPE(zone) int profileScope __attribute__((cleanup(ProfileScopeEnd))) = (ProfileBegin(zone), zone)
+#else
+#define PROFILE_SCOPE(zone) ((void)0)
+#endif
+
+// --- Logging ---
+// Entries go into a fixed ring; producers claim a slot with one atomic add
+// and never wait. Each slot is a seqlock (odd while being written), so the
+// log bar and the file writer can read without locks and detect overwrites.
+typedef enum { LOG_INFO, LOG_SUCCESS, LOG_WARNING, LOG_ERROR } LogLevel;
+typedef enum { LOG_ENGINE, LOG_SCRIPT, LOG_PYTHON } LogSource;
+
+typedef struct {
+    atomic_uint seq;       // 2*ticket+1 while writing, 2*ticket+2 when complete
+    unsigned char level, source;
+    double time;
+    char text[CMD_LEN];
+} LogEntry;
+
+static LogEntry logRing[LOG_RING_CAP];
+static atomic_uint logHead = 0;     // Next ticket
+static bool echoLogs = false; // Headless --verbose: mirror log lines to stdout
+
+static const char* const logLevelNames[] = {"info", "ok", "warning", "error"};
+static const char* const logSourceNames[] = {"engine", "script", "python"};
+
+static void LogMessageV(LogLevel level, LogSource source, const char* fmt, va_list args){
+    unsigned int ticket = atomic_fetch_add_explicit(&logHead, 1, memory_order_relaxed);
+    LogEntry* e = &logRing[ticket & (LOG_RING_CAP-1)];
+    atomic_store_explicit(&e->seq, 2*ticket+1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    vsnprintf(e->text, sizeof(e->text), fmt, args);
+    e->level = (unsigned char)level;
+    e->source = (unsigned char)source;
+    e->time = NowSeconds();
+    atomic_store_explicit(&e->seq, 2*ticket+2, memory_order_release);
+    if(echoLogs) printf("%s\n", e->text);
+}
+
+static void LogMessage(LogLevel level, LogSource source, const char* fmt, ...){
+    va_list args;
+    va_start(args, fmt);
+    LogMessageV(level, source, fmt, args);
+    va_end(args);
+}
+
+// Severity from the format's leading word, decided once when the line is logged
+static LogLevel LogLevelOf(const char* fmt){
+    if(strncmp(fmt, "Error", 5) == 0) return LOG_ERROR;
+    if(strncmp(fmt, "Warning", 7) == 0) return LOG_WARNING;
+    if(strncmp(fmt, "Added", 5) == 0 || strncmp(fmt, "Loaded", 6) == 0 ||
+       strncmp(fmt, "Saved", 5) == 0 || strncmp(fmt, "Executed", 8) == 0) return LOG_SUCCESS;
+    return LOG_INFO;
+}
+
+static void AddLog(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    LogMessageV(LogLevelOf(fmt), LOG_ENGINE, fmt, args);
+    va_end(args);
+}
+
+// Copies entry 'ticket' if it is complete and still in the ring
+static bool ReadLogEntry(unsigned int ticket, LogEntry* out){
+    const LogEntry* e = &logRing[ticket & (LOG_RING_CAP-1)];
+    unsigned int seq = atomic_load_explicit(&e->seq, memory_order_acquire);
+    if(seq != 2*ticket+2) return false;
+    out->level = e->level; out->source = e->source; out->time = e->time;
+    memcpy(out->text, e->text, sizeof(out->text));
+    out->text[sizeof(out->text)-1] = '\0';
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&e->seq, memory_order_relaxed) == seq;
+}
+
+// --- Log file writer ---
+// Background thread streaming the ring to ./Projects/<project>/engine.log,
+// rotating it to engine.1.log ... past LOG_FILE_MAX_BYTES. It polls, so
+// logging never signals or takes a lock.
+static pthread_t logThread;
+static pthread_mutex_t logWriterLock = PTHREAD_MUTEX_INITIALIZER; // Guards the fields below
+static pthread_cond_t logWriterWake = PTHREAD_COND_INITIALIZER;
+static bool logWriterRunning = false, logWriterStop = false;
+static char logProjectDir[256] = "";
+static unsigned int logProjectEpoch = 0;
+
+static void RotateLogFiles(const char* dir){
+    char from[300], to[300];
+    for(int i = LOG_FILE_KEEP; i >= 1; i--){
+        if(i > 1) snprintf(from, sizeof(from), "%s/engine.%d.log", dir, i-1);
+        else snprintf(from, sizeof(from), "%s/engine.log", dir);
+        snprintf(to, sizeof(to), "%s/engine.%d.log", dir, i);
+        remove(to);
+        rename(from, to);
+    }
+}
+
+static FILE* OpenLogFile(const char* dir, long* size){
+    char path[300]; snprintf(path, sizeof(path), "%s/engine.log", dir);
+    FILE* f = fopen(path, "a");
+    *size = f ? ftell(f) : 0;
+    return f;
+}
+
+static void* LogWriterMain(void* arg){
+    unsigned int next = 0, epoch = 0;
+    char dir[256] = "";
+    FILE* f = NULL; long size = 0;
+    for(;;){
+        pthread_mutex_lock(&logWriterLock);
+        if(!logWriterStop){
+            struct timespec wake; clock_gettime(CLOCK_REALTIME, &wake);
+            wake.tv_nsec += 50*1000000L;
+            if(wake.tv_nsec >= 1000000000L){ wake.tv_sec++; wake.tv_nsec -= 1000000000L; }
+            pthread_cond_timedwait(&logWriterWake, &logWriterLock, &wake);
+        }
+        bool stop = logWriterStop;
+        if(epoch != logProjectEpoch){
+            epoch = logProjectEpoch;
+            memcpy(dir, logProjectDir, sizeof(dir));
+            if(f) fclose(f);
+            f = dir[0] ? OpenLogFile(dir, &size) : NULL;
+        }
+        pthread_mutex_unlock(&logWriterLock);
+
+        unsigned int head = atomic_load_explicit(&logHead, memory_order_acquire);
+        if(head - next > LOG_RING_CAP){
+            if(f) size += fprintf(f, "... %u log entries dropped\n", head - next - LOG_RING_CAP);
+            next = head - LOG_RING_CAP;
+        }
+        LogEntry e;
+        for(; next != head; next++){
+            if(!ReadLogEntry(next, &e)){
+                unsigned int seq = atomic_load_explicit(&logRing[next & (LOG_RING_CAP-1)].seq, memory_order_relaxed);
+                if(seq < 2*next+2) break; // Still being written; retry on the next pass
+                continue;                 // Overwritten already
+            }
+            if(!f) continue;
+            size += fprintf(f, "%10.3f %-7s %-6s %s\n", e.time, logLevelNames[e.level], logSourceNames[e.source], e.text);
+            if(size > LOG_FILE_MAX_BYTES){
+                fclose(f);
+                RotateLogFiles(dir);
+                f = OpenLogFile(dir, &size);
+            }
+        }
+        if(f) fflush(f);
+        if(stop && next == head) break;
+    }
+    if(f) fclose(f);
+    return NULL;
+}
+
+// Points the writer at a project's folder (created by the caller)
+static void SetLogProject(const char* project){
+    pthread_mutex_lock(&logWriterLock);
+    snprintf(logProjectDir, sizeof(logProjectDir), "./Projects/%s", project);
+    logProjectEpoch++;
+    pthread_mutex_unlock(&logWriterLock);
+}
+
+static void StartLogWriter(void){
+    if(logWriterRunning) return;
+    logWriterStop = false;
+    logWriterRunning = pthread_create(&logThread, NULL, LogWriterMain, NULL) == 0;
+    if(!logWriterRunning) AddLog("Warning: log file writer could not start");
+}
+
+// Drains what is left and joins the writer
+static void StopLogWriter(void){
+    if(!logWriterRunning) return;
+    pthread_mutex_lock(&logWriterLock);
+    logWriterStop = true;
+    pthread_cond_signal(&logWriterWake);
+    pthread_mutex_unlock(&logWriterLock);
+    pthread_join(logThread, NULL);
+    logWriterRunning = false;
+}
+
+// Initialize Python and set up game API
+static PyObject* PyInit_game(void);
+
+static bool InitializePython() {
+    // The native game module must be registered before the interpreter starts
+    PyImport_AppendInittab("game", PyInit_game);
+    Py_Initialize();
+    if (!Py_IsInitialized()) {
+        AddLog("Failed to initialize Python");
+        return false;
+    }
+    
+    // Expose the game module's functions at top level, as scripts expect
+    PyRun_SimpleString(
+        "# Game Engine API\n"
+        "import game\n"
+        "from game import *\n"
+        "game_objects = game.objects  # Live name -> handle mapping\n"
+        "game_variables = {}\n"
+        "game_commands = []  # Console commands queued here still run after the script\n"
+        "\n"
+        "import math\n"
+        "import time\n"
+    );
+    
+    AddLog("Python initialized with game API");
+    return true;
+}
+
+// --- Utilities ---
+static unsigned int HashName(const char* name){
+    unsigned int h = 2166136261u; // FNV-1a
+    while(*name){ h ^= (unsigned char)*name++; h *= 16777619u; }
+    return h;
+}
+
+static unsigned int HashBytes(const void* data, size_t n){
+    const unsigned char* p = data;
+    unsigned int h = 2166136261u; // FNV-1a
+    while(n--){ h ^= *p++; h *= 16777619u; }
+    return h;
+}
+
+// Resizes a heap array to count elements; a new one is charged to tag
+static bool GrowArray(void** arr, int count, size_t elemSize, MemTag tag){
+    void* p = MemRealloc(tag, *arr, (size_t)count * elemSize);
+    if(!p) return false;
+    *arr = p;
+    return true;
+}
+
+// Reads a whole file in one pass; returns a NUL-terminated buffer from
+// arena, or from the heap (MemFree it) when arena is NULL
+static char* ReadWholeFile(const char* path, long* length, Arena* arena){
+    FILE* f = fopen(path, "rb");
+    if(!f) return NULL;
+    char* data = NULL;
+    long len = -1;
+    if(fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) >= 0 && fseek(f, 0, SEEK_SET) == 0){
+        data = arena ? ArenaAlloc(arena, (size_t)len + 1) : MemAlloc(MEM_IO, (size_t)len + 1);
+        if(data){
+            len = (long)fread(data, 1, (size_t)len, f);
+            data[len] = '\0';
+        }
+    }
+    fclose(f);
+    if(data && length) *length = len;
+    return data;
+}
+
+// Modification time in nanoseconds where the platform records it
+static long long FileMTime(const struct stat* st){
+#if defined(_WIN32) || defined(__APPLE__)
+    return (long long)st->st_mtime * 1000000000LL;
+#else
+    return (long long)st->st_mtim.tv_sec * 1000000000LL + st->st_mtim.tv_nsec;
+#endif
+}
+
+// --- Job system ---
+// Worker pool for data-parallel loops. ParallelFor cuts a range into chunks
+// and deals them onto per-worker deques; a worker takes from the back of its
+// own deque and steals from the front of the others once it runs dry, and
+// the calling thread runs chunks too until its loop is done. Chunk bounds
+// depend only on the range and grain, never on the number of threads, and
+// every chunk writes its own outputs, so results come out the same on any
+// machine. Jobs must not touch Python or anything worldLock guards for writing
+// outside their own range.
+#define JOB_MAX_CHUNKS 256         // Chunks per ParallelFor; also the per-chunk output slots
+#define JOB_QUEUE_CAP 256          // Per worker deque, power of two; a full deque runs the job inline
+#define MAX_JOB_WORKERS 63
+
+typedef void (*JobFn)(void* data, int chunk, int begin, int end);
+
+typedef struct {
+    JobFn fn;
+    void* data;
+    int chunk, begin, end;
+    atomic_int* pending;           // Chunks of the same loop still running
+} Job;
+
+typedef struct {
+    pthread_mutex_t lock;
+    Job jobs[JOB_QUEUE_CAP];
+    unsigned int head, tail;       // Thieves take at head, the owner at tail
+} JobQueue;
+
+static JobQueue* jobQueues = NULL;
+static pthread_t* jobThreads = NULL;
+static int jobWorkerCount = 0;
+static atomic_int jobsQueued;      // Across all deques; idle workers sleep while it is 0
+static atomic_uint jobNextQueue;
+static atomic_bool jobStop;
+static pthread_mutex_t jobSleepLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobWake = PTHREAD_COND_INITIALIZER;
+
+static bool PushJob(JobQueue* q, const Job* job){
+    pthread_mutex_lock(&q->lock);
+    bool ok = q->tail - q->head < JOB_QUEUE_CAP;
+    if(ok){ q->jobs[q->tail++ & (JOB_QUEUE_CAP-1)] = *job; atomic_fetch_add(&jobsQueued, 1); }
+    pthread_mutex_unlock(&q->lock);
+    return ok;
+}
+
+static bool TakeJob(JobQueue* q, Job* job, bool steal){
+    pthread_mutex_lock(&q->lock);
+    bool ok = q->tail != q->head;
+    if(ok){
+        *job = steal ? q->jobs[q->head++ & (JOB_QUEUE_CAP-1)] : q->jobs[--q->tail & (JOB_QUEUE_CAP-1)];
+        atomic_fetch_sub(&jobsQueued, 1);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return ok;
+}
+
+// Own deque first (self < 0 for threads outside the pool), then the others in turn
+static bool FindJob(int self, Job* job){
+    if(self >= 0 && TakeJob(&jobQueues[self], job, false)) return true;
+    if(atomic_load(&jobsQueued) == 0) return false;
+    int first = self >= 0 ? self+1 : (int)(atomic_load(&jobNextQueue) % (unsigned int)jobWorkerCount);
+    for(int k = 0; k < jobWorkerCount; k++){
+        int w = (first + k) % jobWorkerCount;
+        if(w != self && TakeJob(&jobQueues[w], job, true)) return true;
+    }
+    return false;
+}
+
+static void RunJob(const Job* job){
+    job->fn(job->data, job->chunk, job->begin, job->end);
+    atomic_fetch_sub_explicit(job->pending, 1, memory_order_release);
+}
+
+static void* JobWorkerMain(void* arg){
+    int self = (int)(intptr_t)arg;
+    Job job;
+    while(!atomic_load(&jobStop)){
+        if(FindJob(self, &job)){ RunJob(&job); continue; }
+        pthread_mutex_lock(&jobSleepLock);
+        while(!atomic_load(&jobStop) && atomic_load(&jobsQueued) == 0) pthread_cond_wait(&jobWake, &jobSleepLock);
+        pthread_mutex_unlock(&jobSleepLock);
+    }
+    return NULL;
+}
+
+static int CoreCount(void){
+#ifdef _WIN32
+    const char* n = getenv("NUMBER_OF_PROCESSORS");
+    int cores = n ? atoi(n) : 1;
+#else
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return cores > 0 ? cores : 1;
+}
+
+// threads counts the calling thread; <= 0 uses every core
+static void StartJobSystem(int threads){
+    if(threads <= 0) threads = CoreCount();
+    int workers = threads-1 < MAX_JOB_WORKERS ? threads-1 : MAX_JOB_WORKERS;
+    if(workers <= 0) return;
+    jobQueues = MemCalloc(MEM_JOBS, workers, sizeof(JobQueue));
+    jobThreads = MemCalloc(MEM_JOBS, workers, sizeof(pthread_t));
+    if(!jobQueues || !jobThreads){ MemFree(jobQueues); MemFree(jobThreads); jobQueues = NULL; jobThreads = NULL; return; }
+    for(int w = 0; w < workers; w++) pthread_mutex_init(&jobQueues[w].lock, NULL);
+    atomic_store(&jobStop, false);
+    // Deques exist before any worker can steal from them
+    jobWorkerCount = workers;
+    for(int w = 0; w < workers; w++){
+        if(pthread_create(&jobThreads[w], NULL, JobWorkerMain, (void*)(intptr_t)w) != 0){
+            AddLog("Warning: started %d of %d job workers", w, workers);
+            jobWorkerCount = w;
+            break;
+        }
+    }
+}
+
+static void StopJobSystem(void){
+    if(!jobQueues) return;
+    pthread_mutex_lock(&jobSleepLock);
+    atomic_store(&jobStop, true);
+    pthread_cond_broadcast(&jobWake);
+    pthread_mutex_unlock(&jobSleepLock);
+    for(int w = 0; w < jobWorkerCount; w++) pthread_join(jobThreads[w], NULL);
+    MemFree(jobQueues); MemFree(jobThreads);
+    jobQueues = NULL; jobThreads = NULL; jobWorkerCount = 0;
+}
+
+// Calls fn over [0, count) in chunks of at least grain items and returns once
+// all of them ran. Returns the number of chunks; chunk c covers the c-th
+// stretch of the range, so per-chunk outputs merge in order.
+static int ParallelFor(int count, int grain, JobFn fn, void* data){
+    if(count <= 0) return 0;
+    int size = (count + JOB_MAX_CHUNKS-1) / JOB_MAX_CHUNKS;
+    if(size < grain) size = grain;
+    int chunks = (count + size-1) / size;
+    if(chunks == 1 || jobWorkerCount == 0){
+        for(int c = 0; c < chunks; c++) fn(data, c, c*size, c == chunks-1 ? count : (c+1)*size);
+        return chunks;
+    }
+    atomic_int pending; atomic_init(&pending, chunks);
+    // Chunk 0 stays here; the rest are dealt out, highest first so owners start low
+    for(int c = chunks-1; c >= 1; c--){
+        Job job = { fn, data, c, c*size, c == chunks-1 ? count : (c+1)*size, &pending };
+        unsigned int w = atomic_fetch_add(&jobNextQueue, 1) % (unsigned int)jobWorkerCount;
+        if(!PushJob(&jobQueues[w], &job)) RunJob(&job);
+    }
+    pthread_mutex_lock(&jobSleepLock);
+    pthread_cond_broadcast(&jobWake);
+    pthread_mutex_unlock(&jobSleepLock);
+    Job first = { fn, data, 0, 0, size, &pending };
+    RunJob(&first);
+    Job job;
+    while(atomic_load_explicit(&pending, memory_order_acquire) > 0){
+        if(FindJob(-1, &job)) RunJob(&job);
+        else sched_yield();
+    }
+    return chunks;
+}
+
+// --- Text buffers ---
+static TextBuffer* TextBufferNew(void){
+    TextBuffer* b = MemCalloc(MEM_SCRIPTS, 1, sizeof(TextBuffer));
+    if(!b) return NULL;
+    b->refs = 1;
+    b->text.tag = MEM_SCRIPTS;
+    b->layout.tag = MEM_EDITOR;
+    return b;
+}
+
+static TextBuffer* TextBufferRetain(TextBuffer* b){ if(b) b->refs++; return b; }
+
+
+static int TextLineCount(const TextBuffer* b){ return b->capacity - (b->gapEnd - b->gapStart); }
+
+static TextLine* TextLineAt(TextBuffer* b, int i){
+    return &b->lines[i < b->gapStart ? i : i + (b->gapEnd - b->gapStart)];
+}
+
+static void TextBufferRelease(TextBuffer* b){
+    if(!b || --b->refs > 0) return;
+    ArenaFree(&b->text);
+    ArenaFree(&b->layout);
+    MemFree(b->lines);
+    MemFree(b);
+}
+
+static const char* TextLineStr(TextBuffer* b, int i){
+    const TextLine* l = TextLineAt(b, i);
+    return l->text ? l->text : "";
+}
+
+static int TextLineLength(TextBuffer* b, int i){ return TextLineAt(b, i)->len; }
+
+static void TextBufferMoveGap(TextBuffer* b, int pos){
+    if(pos < b->gapStart){
+        int n = b->gapStart - pos;
+        memmove(&b->lines[b->gapEnd - n], &b->lines[pos], n*sizeof(TextLine));
+        b->gapStart -= n; b->gapEnd -= n;
+    } else if(pos > b->gapStart){
+        int n = pos - b->gapStart;
+        memmove(&b->lines[b->gapStart], &b->lines[b->gapEnd], n*sizeof(TextLine));
+        b->gapStart += n; b->gapEnd += n;
+    }
+}
+
+static bool TextLineReserve(TextBuffer* b, TextLine* l, int len){
+    if(len + 1 <= l->capacity) return true;
+    int cap = l->capacity > 16 ? l->capacity : 16;
+    while(cap < len + 1) cap *= 2;
+    char* text = ArenaGrow(&b->text, l->text, (size_t)l->capacity, (size_t)cap);
+    if(!text) return false;
+    if(l->capacity == 0) text[0] = '\0';
+    l->text = text;
+    l->capacity = cap;
+    return true;
+}
+
+static void TextLineChanged(TextLine* l){ if(l->layout) l->layout->valid = false; }
+
+// Opens an empty line before line pos (pos == count appends)
+static TextLine* TextBufferOpenLine(TextBuffer* b, int pos){
+    if(b->gapStart == b->gapEnd){
+        int cap = b->capacity ? b->capacity*2 : 64;
+        if(!GrowArray((void**)&b->lines, cap, sizeof(TextLine), MEM_SCRIPTS)) return NULL;
+        int tail = b->capacity - b->gapEnd;
+        memmove(&b->lines[cap - tail], &b->lines[b->gapEnd], tail*sizeof(TextLine));
+        b->gapEnd = cap - tail;
+        b->capacity = cap;
+    }
+    TextBufferMoveGap(b, pos);
+    TextLine* l = &b->lines[b->gapStart++];
+    memset(l, 0, sizeof(*l));
+    return l;
+}
+
+// Inserts a copy of text as a line before line pos
+static bool TextBufferInsertLine(TextBuffer* b, int pos, const char* text, int len){
+    TextLine* l = TextBufferOpenLine(b, pos);
+    if(!l) return false;
+    if(len > 0){
+        if(!TextLineReserve(b, l, len)) return false;
+        memcpy(l->text, text, len);
+        l->text[len] = '\0';
+        l->len = len;
+    }
+    return true;
+}
+
+// The line's text and layout stay in the arenas until the buffer goes
+static void TextBufferDeleteLine(TextBuffer* b, int pos){
+    TextBufferMoveGap(b, pos);
+    b->gapEnd++;
+}
+
+static void TextLineInsert(TextBuffer* b, int i, int col, const char* text, int n){
+    TextLine* l = TextLineAt(b, i);
+    if(n <= 0 || col < 0 || col > l->len || !TextLineReserve(b, l, l->len + n)) return;
+    memmove(l->text + col + n, l->text + col, l->len - col + 1);
+    memcpy(l->text + col, text, n);
+    l->len += n;
+    TextLineChanged(l);
+}
+
+static void TextLineInsertChar(TextBuffer* b, int i, int col, char ch){ TextLineInsert(b, i, col, &ch, 1); }
+
+static void TextLineEraseChar(TextBuffer* b, int i, int col){
+    TextLine* l = TextLineAt(b, i);
+    if(col < 0 || col >= l->len) return;
+    memmove(l->text + col, l->text + col + 1, l->len - col);
+    l->len--;
+    TextLineChanged(l);
+}
+
+// Reads a file into the buffer's text arena in one piece and splits it in
+// place; a trailing newline doesn't add an empty line
+static TextBuffer* TextBufferLoad(const char* path){
+    TextBuffer* b = TextBufferNew();
+    if(!b) return NULL;
+    long len = 0;
+    char* data = ReadWholeFile(path, &len, &b->text);
+    if(!data){ TextBufferRelease(b); return NULL; }
+    // Lines point into the file data, so none of them may grow in place
+    b->text.last = NULL; b->text.lastSize = 0;
+    for(long start = 0; start < len;){
+        char* nl = memchr(data + start, '\n', (size_t)(len - start));
+        long end = nl ? (long)(nl - data) : len;
+        TextLine* l = TextBufferOpenLine(b, TextLineCount(b));
+        if(!l){ TextBufferRelease(b); return NULL; }
+        data[end] = '\0';
+        if(end > start){ l->text = data + start; l->len = (int)(end - start); l->capacity = l->len + 1; }
+        start = end + 1;
+    }
+    return b;
+}
+
+// --- Scene journal ---
+static void JournalWrite(JournalRecord* r){
+    r->checksum = HashBytes((const unsigned char*)r + sizeof(r->checksum), sizeof(*r) - sizeof(r->checksum));
+    if(fwrite(r, sizeof(*r), 1, journal.file) != 1){
+        AddLog("Error: journal write failed; changes are kept only until the next full save");
+        fclose(journal.file); journal.file = NULL;
+        return;
+    }
+    journal.records++;
+    journal.unsynced = true;
+}
+
+static void JournalObjectRecord(JournalRecord* r, JournalOp op, int i){
+    memset(r, 0, sizeof(*r));
+    r->op = (unsigned char)op;
+    r->kind = objects.shape[i];
+    memcpy(r->name, objects.name[i], NAME_LEN);
+    r->position = objects.position[i];
+    r->size = objects.size[i];
+    r->color = objects.color[i];
+}
+
+static void JournalObjectAdded(int i){
+    if(!journal.file) return;
+    JournalRecord r; JournalObjectRecord(&r, JOURNAL_ADD, i);
+    JournalWrite(&r);
+}
+
+static void JournalObjectDeleted(int i){
+    if(!journal.file) return;
+    JournalRecord r; JournalObjectRecord(&r, JOURNAL_DELETE, i);
+    JournalWrite(&r);
+}
+
+// Queues an object whose position, size or color changed; JournalFlush writes its state
+static void JournalObjectChanged(int i){
+    if(!journal.file || objects.journalPending[i]) return;
+    if(journal.pendingCount == journal.pendingCapacity){
+        int cap = journal.pendingCapacity ? journal.pendingCapacity*2 : 256;
+        if(!GrowArray((void**)&journal.pending, cap, sizeof(ObjectHandle), MEM_JOURNAL)) return;
+        journal.pendingCapacity = cap;
+    }
+    objects.journalPending[i] = 1;
+    journal.pending[journal.pendingCount++] = objects.handle[i];
+}
+
+static void JournalVariableChanged(int slot){
+    if(!journal.file || variables[slot].journalPending) return;
+    if(journal.pendingVariableCount == journal.pendingVariableCapacity){
+        int cap = journal.pendingVariableCapacity ? journal.pendingVariableCapacity*2 : 64;
+        if(!GrowArray((void**)&journal.pendingVariables, cap, sizeof(int), MEM_JOURNAL)) return;
+        journal.pendingVariableCapacity = cap;
+    }
+    variables[slot].journalPending = true;
+    journal.pendingVariables[journal.pendingVariableCount++] = slot;
+}
+
+// --- Variable System ---
+static int FindVariable(const char* name) {
+    if(variableIndexCap == 0) return -1;
+    unsigned int hash = HashName(name);
+    int mask = variableIndexCap-1;
+    for(int b = hash & mask; variableIndex[b]; b = (b+1) & mask) {
+        Variable* v = &variables[variableIndex[b]-1];
+        if(v->nameHash == hash && strcmp(v->name, name) == 0) return variableIndex[b]-1;
+    }
+    return -1;
+}
+
+// Returns the slot for name, creating an undefined (zero) variable if needed
+static int InternVariable(const char* name) {
+    int slot = FindVariable(name);
+    if(slot >= 0) return slot;
+    if(variableCount == variableCapacity) {
+        int cap = variableCapacity ? variableCapacity*2 : 64;
+        if(!GrowArray((void**)&variables, cap, sizeof(Variable), MEM_VARIABLES)) return -1;
+        variableCapacity = cap;
+    }
+    if((variableCount+1)*2 > variableIndexCap) {
+        int cap = variableIndexCap ? variableIndexCap*2 : 128;
+        int* table = MemCalloc(MEM_VARIABLES, cap, sizeof(int));
+        if(!table) return -1;
+        for(int i = 0; i < variableCount; i++) {
+            int b = variables[i].nameHash & (cap-1);
+            while(table[b]) b = (b+1) & (cap-1);
+            table[b] = i+1;
+        }
+        MemFree(variableIndex);
+        variableIndex = table; variableIndexCap = cap;
+    }
+    slot = variableCount++;
+    Variable* v = &variables[slot];
+    memset(v, 0, sizeof(*v));
+    strncpy(v->name, name, NAME_LEN-1);
+    v->nameHash = HashName(v->name);
+    int b = v->nameHash & (variableIndexCap-1);
+    while(variableIndex[b]) b = (b+1) & (variableIndexCap-1);
+    variableIndex[b] = slot+1;
+    return slot;
+}
+
+// Scalar view of a variable; component picks .x/.y or .r/.g/.b/.a
+static float VariableValue(int slot, int component) {
+    const Variable* v = &variables[slot];
+    switch(v->type) {
+        case VAR_INT: return (float)v->value.i;
+        case VAR_VEC2: return component == 2 ? v->value.v.y : v->value.v.x;
+        case VAR_COLOR:
+            switch(component) {
+                case 2: return v->value.c.g;
+                case 3: return v->value.c.b;
+                case 4: return v->value.c.a;
+                default: return v->value.c.r;
+            }
+        default: return v->value.f;
+    }
+}
+
+// Assigns a scalar: int variables stay int, a component writes into the
+// vec2/color in place, anything else becomes a float
+static void SetVariableValue(int slot, int component, float value) {
+    Variable* v = &variables[slot];
+    v->defined = true;
+    JournalVariableChanged(slot);
+    if(component && v->type == VAR_VEC2) {
+        if(component == 2) v->value.v.y = value; else v->value.v.x = value;
+    } else if(component && v->type == VAR_COLOR) {
+        unsigned char c = (unsigned char)Clamp(value, 0, 255);
+        switch(component) {
+            case 2: v->value.c.g = c; break;
+            case 3: v->value.c.b = c; break;
+            case 4: v->value.c.a = c; break;
+            default: v->value.c.r = c; break;
+        }
+    } else if(v->type == VAR_INT) {
+        v->value.i = (int)value;
+    } else {
+        v->type = VAR_FLOAT;
+        v->value.f = value;
+    }
+}
+
+static void SetVariable(const char* name, float value) {
+    int slot = InternVariable(name);
+    if(slot >= 0) SetVariableValue(slot, 0, value);
+}
+
+// Splits "name.x" style references into a base name and component index
+static int ParseVariableRef(const char* ref, char* base) {
+    strncpy(base, ref, NAME_LEN-1);
+    base[NAME_LEN-1] = '\0';
+    char* dot = strchr(base, '.');
+    if(!dot || dot[1] == '\0' || dot[2] != '\0') return 0;
+    int component = 0;
+    switch(dot[1]) {
+        case 'x': case 'r': component = 1; break;
+        case 'y': case 'g': component = 2; break;
+        case 'b': component = 3; break;
+        case 'a': component = 4; break;
+        default: return 0;
+    }
+    *dot = '\0';
+    return component;
+}
+
+static void FormatVariable(const Variable* v, char* out, size_t size) {
+    switch(v->type) {
+        case VAR_INT: snprintf(out, size, "%s: %d", v->name, v->value.i); break;
+        case VAR_VEC2: snprintf(out, size, "%s: (%.1f, %.1f)", v->name, v->value.v.x, v->value.v.y); break;
+        case VAR_COLOR: snprintf(out, size, "%s: rgba(%d,%d,%d,%d)", v->name, v->value.c.r, v->value.c.g, v->value.c.b, v->value.c.a); break;
+        default: snprintf(out, size, "%s: %.1f", v->name, v->value.f); break;
+    }
+}
+
+// --- Spatial grid ---
+static int GridCoord(float v){
+    float c = floorf(v / GRID_CELL);
+    if(!(c > -1e6f)) return -1000000; // Also catches NaN
+    if(c > 1e6f) return 1000000;
+    return (int)c;
+}
+
+static unsigned int GridHash(int cx, int cy){
+    return ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+}
+
+static int GridProbe(const GridCell* cells, int capacity, int cx, int cy){
+    int mask = capacity-1;
+    int b = GridHash(cx, cy) & mask;
+    while(cells[b].used && (cells[b].cx != cx || cells[b].cy != cy)) b = (b+1) & mask;
+    return b;
+}
+
+static int GridFindCell(int cx, int cy){
+    if(grid.capacity == 0) return -1;
+    int b = GridProbe(grid.cells, grid.capacity, cx, cy);
+    return grid.cells[b].used ? b : -1;
+}
+
+static void GridCellMoved(int b){
+    for(int i = grid.cells[b].head; i >= 0; i = objects.gridNext[i]) objects.gridCell[i] = b;
+}
+
+// Rehashing moves cells, so every linked object gets its new cell index
+static bool GridResize(int cap){
+    GridCell* cells = MemCalloc(MEM_GRID, cap, sizeof(GridCell));
+    if(!cells) return false;
+    for(int b = 0; b < grid.capacity; b++){
+        if(!grid.cells[b].used) continue;
+        int nb = GridProbe(cells, cap, grid.cells[b].cx, grid.cells[b].cy);
+        cells[nb] = grid.cells[b];
+    }
+    MemFree(grid.cells);
+    grid.cells = cells;
+    grid.capacity = cap;
+    for(int b = 0; b < cap; b++) if(cells[b].used) GridCellMoved(b);
+    return true;
+}
+
+// Backward-shift delete: later cells of the probe run move up into the hole,
+// so lookups never need tombstones. The table halves once it is 1/8 full.
+static void GridRemoveCell(int b){
+    int mask = grid.capacity-1, hole = b;
+    for(int j = (b+1) & mask; grid.cells[j].used; j = (j+1) & mask){
+        int home = GridHash(grid.cells[j].cx, grid.cells[j].cy) & mask;
+        if(((j - home) & mask) < ((j - hole) & mask)) continue; // Home lies between hole and j
+        grid.cells[hole] = grid.cells[j];
+        GridCellMoved(hole);
+        hole = j;
+    }
+    grid.cells[hole] = (GridCell){ 0, 0, -1, false };
+    grid.used--;
+    if(grid.capacity > 1024 && grid.used*8 < grid.capacity) GridResize(grid.capacity/2);
+}
+
+static int GridCellFor(int i){
+    if(objects.size[i] > GRID_CELL) return GRID_LARGE;
+    int cx = GridCoord(objects.position[i].x), cy = GridCoord(objects.position[i].y);
+    int b = GridFindCell(cx, cy);
+    if(b >= 0) return b;
+    if((grid.used+1)*2 > grid.capacity && !GridResize(grid.capacity ? grid.capacity*2 : 1024)) return GRID_LARGE;
+    b = GridProbe(grid.cells, grid.capacity, cx, cy);
+    grid.cells[b] = (GridCell){ cx, cy, -1, true };
+    grid.used++;
+    return b;
+}
+
+static int* GridHead(int cell){ return cell == GRID_LARGE ? &grid.largeHead : &grid.cells[cell].head; }
+
+static void GridUnlink(int i){
+    int cell = objects.gridCell[i];
+    if(cell == -1) return;
+    if(objects.gridPrev[i] >= 0) objects.gridNext[objects.gridPrev[i]] = objects.gridNext[i];
+    else *GridHead(cell) = objects.gridNext[i];
+    if(objects.gridNext[i] >= 0) objects.gridPrev[objects.gridNext[i]] = objects.gridPrev[i];
+    objects.gridCell[i] = -1;
+    if(cell != GRID_LARGE && grid.cells[cell].head < 0) GridRemoveCell(cell);
+}
+
+static void GridLink(int i, int cell){
+    int* head = GridHead(cell);
+    objects.gridCell[i] = cell;
+    objects.gridPrev[i] = -1;
+    objects.gridNext[i] = *head;
+    if(*head >= 0) objects.gridPrev[*head] = i;
+    *head = i;
+}
+
+// Whether object i is still filed where its position and size put it. Read
+// only. Compares against the cell's bounds, which is what GridCoord's floor
+// comes to; positions clamped by GridCoord just report a change.
+static bool GridCellCurrent(int i){
+    int cell = objects.gridCell[i];
+    if(objects.size[i] > GRID_CELL) return cell == GRID_LARGE;
+    if(cell < 0) return false;
+    float x0 = grid.cells[cell].cx * GRID_CELL, y0 = grid.cells[cell].cy * GRID_CELL;
+    Vector2 p = objects.position[i];
+    return p.x >= x0 && p.x < x0 + GRID_CELL && p.y >= y0 && p.y < y0 + GRID_CELL;
+}
+
+// Refiles object i after its position or size changed. Unlinking comes
+// first: removing the cell it empties can move other cells around.
+static void GridUpdate(int i){
+    if(GridCellCurrent(i)) return;
+    GridUnlink(i);
+    GridLink(i, GridCellFor(i));
+}
+
+typedef struct { const int* indices; unsigned char* moved; } GridRefreshJob;
+
+static void GridRefreshChunk(void* data, int chunk, int begin, int end){
+    const GridRefreshJob* job = data;
+    for(int k = begin; k < end; k++) job->moved[k] = !GridCellCurrent(job->indices ? job->indices[k] : k);
+}
+
+// GridUpdate for many objects (indices, or the first n when NULL): finding
+// the ones that left their cell runs in parallel, relinking those is serial
+static void GridRefresh(const int* indices, int n){
+    static unsigned char* moved = NULL; static int movedCap = 0;
+    if(n > movedCap){
+        if(!GrowArray((void**)&moved, n, 1, MEM_GRID)){
+            for(int k = 0; k < n; k++) GridUpdate(indices ? indices[k] : k);
+            return;
+        }
+        movedCap = n;
+    }
+    GridRefreshJob job = { indices, moved };
+    ParallelFor(n, 4096, GridRefreshChunk, &job);
+    for(int k = 0; k < n; k++) if(moved[k]) GridUpdate(indices ? indices[k] : k);
+}
+
+// The swap-remove in RemoveObject moved object 'from' to dense index 'to'
+static void GridRelocate(int from, int to){
+    objects.gridCell[to] = objects.gridCell[from];
+    objects.gridNext[to] = objects.gridNext[from];
+    objects.gridPrev[to] = objects.gridPrev[from];
+    if(objects.gridCell[to] == -1) return;
+    if(objects.gridPrev[to] >= 0) objects.gridNext[objects.gridPrev[to]] = to;
+    else *GridHead(objects.gridCell[to]) = to;
+    if(objects.gridNext[to] >= 0) objects.gridPrev[objects.gridNext[to]] = to;
+}
+
+static bool PointInObject(Vector2 p,int i){
+    Vector2 pos=objects.position[i]; float size=objects.size[i];
+    if(objects.shape[i]==SHAPE_CIRCLE) return Vector2Distance(p,pos)<=size;
+    return (p.x>=pos.x-size && p.x<=pos.x+size && p.y>=pos.y-size && p.y<=pos.y+size);
+}
+
+// Topmost (highest index, drawn last) object under p, or -1
+static int PickObject(Vector2 p){
+    int picked = -1;
+    int cx = GridCoord(p.x), cy = GridCoord(p.y);
+    for(int y = cy-1; y <= cy+1; y++){
+        for(int x = cx-1; x <= cx+1; x++){
+            int b = GridFindCell(x, y);
+            if(b < 0) continue;
+            for(int i = grid.cells[b].head; i >= 0; i = objects.gridNext[i])
+                if(i > picked && PointInObject(p, i)) picked = i;
+        }
+    }
+    for(int i = grid.largeHead; i >= 0; i = objects.gridNext[i])
+        if(i > picked && PointInObject(p, i)) picked = i;
+    return picked;
+}
+
+static int CompareInts(const void* a, const void* b){
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+#define LABEL_MARGIN (24.0f + NAME_LEN*4.0f) // Name labels sit above the body, centered
+
+// Appends the objects of one grid list that can reach view
+static int CollectVisible(int head, Rectangle view, int n, int** out, int* outCap){
+    for(int i = head; i >= 0; i = objects.gridNext[i]){
+        Vector2 pos = objects.position[i]; float r = objects.size[i];
+        if(pos.x + r + LABEL_MARGIN < view.x || pos.x - r - LABEL_MARGIN > view.x + view.width ||
+           pos.y + r < view.y || pos.y - r - LABEL_MARGIN > view.y + view.height) continue;
+        if(n == *outCap){
+            int cap = *outCap ? *outCap*2 : 1024;
+            if(!GrowArray((void**)out, cap, sizeof(int), MEM_RENDER)) return n;
+            *outCap = cap;
+        }
+        (*out)[n++] = i;
+    }
+    return n;
+}
+
+// Objects whose body or name label can reach view, in draw order. Returns
+// the count; *out is a reused buffer owned by the caller.
+static int QueryVisibleObjects(Rectangle view, int** out, int* outCap){
+    int n = 0;
+    int x0 = GridCoord(view.x - GRID_CELL - LABEL_MARGIN), x1 = GridCoord(view.x + view.width + GRID_CELL + LABEL_MARGIN);
+    int y0 = GridCoord(view.y - GRID_CELL), y1 = GridCoord(view.y + view.height + GRID_CELL + LABEL_MARGIN);
+    for(int y = y0; y <= y1; y++){
+        for(int x = x0; x <= x1; x++){
+            int b = GridFindCell(x, y);
+            if(b >= 0) n = CollectVisible(grid.cells[b].head, view, n, out, outCap);
+        }
+    }
+    n = CollectVisible(grid.largeHead, view, n, out, outCap);
+    qsort(*out, n, sizeof(int), CompareInts);
+    return n;
+}
+
+// --- Objects ---
+// Reallocates every column to cap rows; on failure the ones already done
+// keep their new size, the rest their old one
+static bool ObjectStoreResize(int cap){
+    if(!GrowArray((void**)&objects.position, cap, sizeof(Vector2), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.previous, cap, sizeof(Vector2), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.velocity, cap, sizeof(Vector2), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.acceleration, cap, sizeof(Vector2), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.damping, cap, sizeof(float), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.size, cap, sizeof(float), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.color, cap, sizeof(Color), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.shape, cap, sizeof(unsigned char), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.selected, cap, sizeof(bool), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.name, cap, NAME_LEN, MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.nameHash, cap, sizeof(unsigned int), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.handle, cap, sizeof(ObjectHandle), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.dirty, cap, sizeof(unsigned char), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.journalPending, cap, sizeof(unsigned char), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.labelWidth, cap, sizeof(float), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.labelEpoch, cap, sizeof(unsigned int), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.gridCell, cap, sizeof(int), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.gridNext, cap, sizeof(int), MEM_OBJECTS) ||
+       !GrowArray((void**)&objects.gridPrev, cap, sizeof(int), MEM_OBJECTS)) return false;
+    return true;
+}
+
+static bool ObjectStoreReserve(int needed){
+    if(needed <= objects.capacity) return true;
+    if(objects.viewExports > 0){
+        AddLog("Error: object store is locked by %d Python view(s)", objects.viewExports);
+        return false;
+    }
+    int cap = objects.capacity ? objects.capacity : 64;
+    while(cap < needed) cap *= 2;
+    if(!ObjectStoreResize(cap)) return false;
+    objects.capacity = cap;
+    return true;
+}
+
+static int ObjectIndex(ObjectHandle h){
+    unsigned int slot = (h & HANDLE_SLOT_MASK);
+    if(slot == 0 || (int)slot > objects.slotCount) return -1;
+    slot--;
+    if(objects.slotGeneration[slot] != (h >> HANDLE_SLOT_BITS)) return -1;
+    return objects.slotIndex[slot];
+}
+
+// Returns the bucket holding name, or the empty bucket where it would go
+static int NameIndexSlot(const char* name, unsigned int hash){
+    int mask = nameIndexCap-1;
+    int b = hash & mask;
+    while(nameIndex[b] != INVALID_HANDLE){
+        int i = ObjectIndex(nameIndex[b]);
+        if(objects.nameHash[i] == hash && strcmp(objects.name[i], name) == 0) return b;
+        b = (b+1) & mask;
+    }
+    return b;
+}
+
+static bool NameIndexRebuild(int cap){
+    ObjectHandle* table = MemCalloc(MEM_NAMES, cap, sizeof(ObjectHandle));
+    if(!table) return false;
+    for(int i=0;i<objects.count;i++){
+        int b = objects.nameHash[i] & (cap-1);
+        while(table[b] != INVALID_HANDLE) b = (b+1) & (cap-1);
+        table[b] = objects.handle[i];
+    }
+    MemFree(nameIndex);
+    nameIndex = table; nameIndexCap = cap;
+    return true;
+}
+
+static bool NameIndexReserve(int needed){
+    if(needed*2 <= nameIndexCap) return true;
+    int cap = nameIndexCap ? nameIndexCap : 256;
+    while(needed*2 > cap) cap *= 2;
+    return NameIndexRebuild(cap);
+}
+
+static ObjectHandle FindHandle(const char* name){
+    if(nameIndexCap == 0) return INVALID_HANDLE;
+    return nameIndex[NameIndexSlot(name, HashName(name))];
+}
+
+// Backward-shift delete keeps probe chains intact without tombstones
+static void NameIndexRemove(const char* name, unsigned int hash){
+    int mask = nameIndexCap-1;
+    int hole = NameIndexSlot(name, hash);
+    if(nameIndex[hole] == INVALID_HANDLE) return;
+    int b = hole;
+    for(;;){
+        b = (b+1) & mask;
+        if(nameIndex[b] == INVALID_HANDLE) break;
+        int home = objects.nameHash[ObjectIndex(nameIndex[b])] & mask;
+        // Move b into the hole unless its home lies cyclically in (hole, b]
+        bool stays = (hole <= b) ? (home > hole && home <= b) : (home > hole || home <= b);
+        if(!stays){ nameIndex[hole] = nameIndex[b]; hole = b; }
+    }
+    nameIndex[hole] = INVALID_HANDLE;
+}
+
+static int FindByName(const char* name){
+    return ObjectIndex(FindHandle(name));
+}
+
+// Accepts either an object name or a cached handle written as "#<handle>";
+// returns the dense index or -1
+static int ResolveObject(const char* ref){
+    if(ref[0] == '#' && isdigit((unsigned char)ref[1])) return ObjectIndex((ObjectHandle)strtoul(ref+1, NULL, 10));
+    return FindByName(ref);
+}
+
+static ObjectHandle AllocHandle(int denseIndex){
+    int slot;
+    if(objects.freeSlotCount > 0) slot = objects.freeSlots[--objects.freeSlotCount];
+    else {
+        if(objects.slotCount >= MAX_OBJECTS) return INVALID_HANDLE;
+        if(objects.slotCount == objects.slotCapacity){
+            int cap = objects.slotCapacity ? objects.slotCapacity*2 : 64;
+            if(!GrowArray((void**)&objects.slotIndex, cap, sizeof(int), MEM_OBJECTS) ||
+               !GrowArray((void**)&objects.slotGeneration, cap, sizeof(unsigned short), MEM_OBJECTS) ||
+               !GrowArray((void**)&objects.freeSlots, cap, sizeof(int), MEM_OBJECTS)) return INVALID_HANDLE;
+            objects.slotCapacity = cap;
+        }
+        slot = objects.slotCount++;
+        objects.slotGeneration[slot] = 0;
+    }
+    objects.slotIndex[slot] = denseIndex;
+    return ((ObjectHandle)objects.slotGeneration[slot] << HANDLE_SLOT_BITS) | (ObjectHandle)(slot+1);
+}
+
+// Adds an object without the success log line (journal replay adds thousands)
+static ObjectHandle InsertObject(const char* name, ShapeType shape, Vector2 pos, float size, Color col){
+    char key[NAME_LEN] = {0};
+    strncpy(key, name, NAME_LEN-1);
+    int i = objects.count;
+    if(!ObjectStoreReserve(i+1) || !NameIndexReserve(i+1)){ AddLog("Error: object limit reached"); return INVALID_HANDLE; }
+    unsigned int hash = HashName(key);
+    int bucket = NameIndexSlot(key, hash);
+    if(nameIndex[bucket] != INVALID_HANDLE){ AddLog("Error: name '%s' exists", name); return INVALID_HANDLE; }
+    ObjectHandle h = AllocHandle(i);
+    if(h == INVALID_HANDLE){ AddLog("Error: object limit reached"); return INVALID_HANDLE; }
+
+    memcpy(objects.name[i], key, NAME_LEN);
+    objects.nameHash[i] = hash;
+    objects.handle[i] = h;
+    objects.position[i] = pos;
+    objects.previous[i] = pos;
+    objects.velocity[i] = (Vector2){0, 0};
+    objects.acceleration[i] = (Vector2){0, 0};
+    objects.damping[i] = 0;
+    objects.size[i] = (size <= 0 ? 1 : size);
+    objects.color[i] = col;
+    objects.shape[i] = (unsigned char)shape;
+    objects.selected[i] = false;
+    objects.dirty[i] = 0;
+    objects.journalPending[i] = 0;
+    objects.labelEpoch[i] = 0;
+    objects.gridCell[i] = -1;
+    GridUpdate(i);
+    objects.count++;
+    nameIndex[bucket] = h;
+    JournalObjectAdded(i);
+    return h;
+}
+
+static ObjectHandle AddObject(const char* name, ShapeType shape, Vector2 pos, float size, Color col){
+    ObjectHandle h = InsertObject(name, shape, pos, size, col);
+    if(h != INVALID_HANDLE) AddLog("Added %s '%s'", shape==SHAPE_CIRCLE?"circle":"rect", name);
+    return h;
+}
+
+static void RemoveObject(int i){
+    JournalObjectDeleted(i);
+    NameIndexRemove(objects.name[i], objects.nameHash[i]);
+
+    int slot = (objects.handle[i] & HANDLE_SLOT_MASK) - 1;
+    objects.slotIndex[slot] = -1;
+    objects.slotGeneration[slot] = (objects.slotGeneration[slot]+1) & ((1u<<(32-HANDLE_SLOT_BITS))-1);
+    objects.freeSlots[objects.freeSlotCount++] = slot;
+
+    GridUnlink(i);
+
+    // Swap-remove: move the last object into the hole
+    int last = objects.count-1;
+    if(i != last){
+        GridRelocate(last, i);
+        objects.position[i] = objects.position[last];
+        objects.previous[i] = objects.previous[last];
+        objects.velocity[i] = objects.velocity[last];
+        objects.acceleration[i] = objects.acceleration[last];
+        objects.damping[i] = objects.damping[last];
+        objects.size[i] = objects.size[last];
+        objects.color[i] = objects.color[last];
+        objects.shape[i] = objects.shape[last];
+        objects.selected[i] = objects.selected[last];
+        memcpy(objects.name[i], objects.name[last], NAME_LEN);
+        objects.nameHash[i] = objects.nameHash[last];
+        objects.handle[i] = objects.handle[last];
+        objects.dirty[i] = objects.dirty[last];
+        objects.journalPending[i] = objects.journalPending[last];
+        objects.labelWidth[i] = objects.labelWidth[last];
+        objects.labelEpoch[i] = objects.labelEpoch[last];
+        objects.slotIndex[(objects.handle[i] & HANDLE_SLOT_MASK) - 1] = i;
+    }
+    objects.count--;
+}
+
+// The swap-remove would move rows under live Python views, so it waits for them
+static bool DeleteObject(const char* name){
+    if(objects.viewExports > 0){ AddLog("Error: object store is locked by %d Python view(s)", objects.viewExports); return false; }
+    int i = ResolveObject(name);
+    if(i < 0){ AddLog("Error: '%s' not found",name); return false; }
+    char deleted[NAME_LEN]; memcpy(deleted, objects.name[i], NAME_LEN);
+    RemoveObject(i);
+    AddLog("Deleted '%s'",deleted);
+    return true;
+}
+
+// Removes every object; their handles go stale like after RemoveObject
+static bool ClearObjects(void){
+    if(objects.viewExports > 0){ AddLog("Error: object store is locked by %d Python view(s)", objects.viewExports); return false; }
+    for(int i = 0; i < objects.count; i++){
+        int slot = (objects.handle[i] & HANDLE_SLOT_MASK) - 1;
+        objects.slotIndex[slot] = -1;
+        objects.slotGeneration[slot] = (objects.slotGeneration[slot]+1) & ((1u<<(32-HANDLE_SLOT_BITS))-1);
+        objects.freeSlots[objects.freeSlotCount++] = slot;
+    }
+    objects.count = 0;
+    objects.dirtyCount = 0;
+    objects.moving = false;
+    objects.motionUnsaved = false;
+    journal.pendingCount = 0;
+    if(nameIndex) memset(nameIndex, 0, nameIndexCap*sizeof(ObjectHandle));
+    MemFree(grid.cells);
+    grid = (SpatialGrid){ NULL, 0, 0, -1 };
+    return true;
+}
+
+// Hands back the column and name-index space a bigger project left behind,
+// so opening a small project after a large one shrinks the store
+static void ObjectStoreTrim(void){
+    if(objects.viewExports > 0) return;
+    int cap = 64;
+    while(cap < objects.count) cap *= 2;
+    if(cap * 4 <= objects.capacity){
+        ObjectStoreResize(cap); // Shrinking columns that fail keep their larger size
+        objects.capacity = cap;
+    }
+    int indexCap = 256;
+    while(objects.count*2 > indexCap) indexCap *= 2;
+    if(indexCap * 4 <= nameIndexCap) NameIndexRebuild(indexCap);
+}
+
+// Every single-object position write goes through here to keep the grid current
+static void SetObjectPosition(int i, Vector2 pos){
+    objects.position[i] = pos;
+    GridUpdate(i);
+    JournalObjectChanged(i);
+}
+
+static void SetObjectColor(int i, Color c){
+    objects.color[i] = c;
+    JournalObjectChanged(i);
+}
+
+// Queues an object whose columns were written in bulk
+static void MarkObjectDirty(int i){
+    if(objects.dirty[i]) return;
+    if(objects.dirtyCount == objects.dirtyCapacity){
+        int cap = objects.dirtyCapacity ? objects.dirtyCapacity*2 : 256;
+        if(!GrowArray((void**)&objects.dirtyList, cap, sizeof(ObjectHandle), MEM_OBJECTS)) return;
+        objects.dirtyCapacity = cap;
+    }
+    objects.dirty[i] = 1;
+    objects.dirtyList[objects.dirtyCount++] = objects.handle[i];
+}
+
+// Re-validates objects written through views (sizes stay >= 1, like AddObject)
+static void ApplyObjectChanges(void){
+    static int* changed = NULL; static int changedCap = 0;
+    if(objects.dirtyCount == 0) return;
+    if(objects.dirtyCount > changedCap){
+        if(GrowArray((void**)&changed, objects.dirtyCount, sizeof(int), MEM_OBJECTS)) changedCap = objects.dirtyCount;
+    }
+    int n = 0;
+    for(int k = 0; k < objects.dirtyCount; k++){
+        int i = ObjectIndex(objects.dirtyList[k]);
+        if(i < 0) continue; // Deleted since it was marked
+        if(!(objects.size[i] > 0)) objects.size[i] = 1;
+        if(n < changedCap) changed[n++] = i; else GridUpdate(i);
+        JournalObjectChanged(i);
+        objects.dirty[i] = 0;
+    }
+    GridRefresh(changed, n);
+    objects.dirtyCount = 0;
+    objects.version++;
+}
+
+// --- Collision ---
+// Overlap tests between objects, run after every tick's scripts and hooks.
+// Broadphase is the spatial grid, which object writes already keep current:
+// a pass packs each cell's members into contiguous rows and tests every cell
+// against itself and the cells after it within reach (twice the largest
+// gridded size, so one or two cells). Narrowphase tests one row against four
+// at a time (SSE2, scalar elsewhere). Cells are split into chunks on the job
+// pool and merged in chunk order, so pairs come out the same for any thread
+// count. Objects in the grid's side list are packed last and tested against
+// the cells they can reach. Circles use size as radius, rects as half extent.
+typedef struct { ObjectHandle a, b; } CollisionPair;     // a is drawn below b
+typedef struct { ObjectHandle a, b; bool began; } CollisionEvent;
+
+typedef struct { int* rows; int count, capacity; } PairChunk; // Packed row pairs
+
+typedef struct {
+    bool enabled;
+    CollisionPair* pairs;            // Overlapping as of the last pass
+    int pairCount, pairCapacity;
+    CollisionPair* previous;         // Of the pass before
+    int previousCount, previousCapacity;
+    CollisionEvent* events;          // Pairs that began or stopped overlapping in the last pass
+    int eventCount, eventCapacity;
+    unsigned long long* set;         // Keys of pairs / previous, open addressing (0 = empty)
+    unsigned long long* previousSet;
+    int setCapacity, previousSetCapacity;
+    int* contacts;                   // Per handle slot, valid while contactOwner matches
+    ObjectHandle* contactOwner;
+    int contactCapacity;
+    // Packed rows: grid cells in bucket order, then the side list
+    float *x, *y, *size;
+    unsigned int* rect;              // All ones for rects, a lane mask
+    int* row;                        // Dense index
+    int rowCapacity;
+    int* cellStart;                  // Per grid bucket
+    int* cellCount;
+    int cellCapacity;
+    int largeStart, largeCount;
+    int reach;                       // Neighbor cells a gridded object can overlap
+    double passTime;
+} CollisionWorld;
+
+static CollisionWorld collision = {0};
+static PairChunk pairChunks[JOB_MAX_CHUNKS];
+static PairChunk largePairs;
+static float chunkMaxSize[JOB_MAX_CHUNKS];
+
+static unsigned long long PairKey(ObjectHandle a, ObjectHandle b){
+    return a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+}
+
+static int PairSetProbe(const unsigned long long* set, int capacity, unsigned long long key){
+    int mask = capacity-1;
+    int b = (int)((key * 0x9E3779B97F4A7C15ull) >> 40) & mask;
+    while(set[b] && set[b] != key) b = (b+1) & mask;
+    return b;
+}
+
+static bool PairSetHas(const unsigned long long* set, int capacity, unsigned long long key){
+    return capacity > 0 && set[PairSetProbe(set, capacity, key)] == key;
+}
+
+// Rebuilds a set holding exactly the given pairs, at most half full
+static bool PairSetBuild(unsigned long long** set, int* capacity, const CollisionPair* pairs, int n){
+    int cap = *capacity ? *capacity : 1024;
+    while(cap < n*2) cap *= 2;
+    if(cap != *capacity){
+        if(!GrowArray((void**)set, cap, sizeof(unsigned long long), MEM_COLLISION)){ *capacity = 0; return false; }
+        *capacity = cap;
+    }
+    memset(*set, 0, (size_t)cap * sizeof(unsigned long long));
+    for(int k = 0; k < n; k++){
+        unsigned long long key = PairKey(pairs[k].a, pairs[k].b);
+        (*set)[PairSetProbe(*set, cap, key)] = key;
+    }
+    return true;
+}
+
+static void PairChunkAdd(PairChunk* c, int i, int j){
+    if(c->count + 2 > c->capacity){
+        int cap = c->capacity ? c->capacity*2 : 256;
+        if(!GrowArray((void**)&c->rows, cap, sizeof(int), MEM_COLLISION)) return;
+        c->capacity = cap;
+    }
+    c->rows[c->count++] = i;
+    c->rows[c->count++] = j;
+}
+
+#if !defined(__SSE2__)
+static bool ShapesOverlap(float dx, float dy, float as, bool arect, float bs, bool brect){
+    float adx = fabsf(dx), ady = fabsf(dy), sum = as + bs;
+    if(arect && brect) return (adx > ady ? adx : ady) < sum;
+    if(!arect && !brect) return dx*dx + dy*dy < sum*sum;
+    float h = arect ? as : bs, r = arect ? bs : as;   // Rect half extent, circle radius
+    float qx = adx > h ? adx - h : 0, qy = ady > h ? ady - h : 0;
+    return qx*qx + qy*qy < r*r;
+}
+#endif
+
+// Appends every row in [first, first+count) that overlaps row i
+static void CollideRow(PairChunk* out, int i, int first, int count){
+    const CollisionWorld* c = &collision;
+    int j = first, end = first + count;
+#if defined(__SSE2__)
+    const __m128 ax = _mm_set1_ps(c->x[i]), ay = _mm_set1_ps(c->y[i]), as = _mm_set1_ps(c->size[i]);
+    const __m128 zero = _mm_setzero_ps(), absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const bool arect = c->rect[i] != 0;
+    for(; j < end; j += 4){
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(c->x + j), ax), dy = _mm_sub_ps(_mm_loadu_ps(c->y + j), ay);
+        __m128 bs = _mm_loadu_ps(c->size + j);
+        __m128 adx = _mm_and_ps(dx, absMask), ady = _mm_and_ps(dy, absMask), sum = _mm_add_ps(as, bs);
+        // Bounding boxes first: that settles most lanes, and every rect pair
+        __m128 box = _mm_cmplt_ps(_mm_max_ps(adx, ady), sum);
+        if(_mm_movemask_ps(box) == 0) continue;
+        __m128 brect = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(c->rect + j)));
+        // Circles: disc test; mixed: distance from the rect to the circle's center
+        __m128 h = arect ? as : bs, r = arect ? bs : as;
+        __m128 qx = _mm_max_ps(_mm_sub_ps(adx, h), zero), qy = _mm_max_ps(_mm_sub_ps(ady, h), zero);
+        __m128 mixed = _mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)), _mm_mul_ps(r, r));
+        __m128 hit;
+        if(arect) hit = _mm_or_ps(_mm_and_ps(brect, box), _mm_andnot_ps(brect, mixed));
+        else {
+            __m128 disc = _mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(sum, sum));
+            hit = _mm_or_ps(_mm_and_ps(brect, mixed), _mm_andnot_ps(brect, disc));
+        }
+        int bits = _mm_movemask_ps(hit);
+        if(end - j < 4) bits &= (1 << (end - j)) - 1;   // Rows past the range are padding or other cells
+        while(bits){
+            int lane = __builtin_ctz(bits);
+            PairChunkAdd(out, i, j + lane);
+            bits &= bits - 1;
+        }
+    }
+#else
+    for(; j < end; j++)
+        if(ShapesOverlap(c->x[j] - c->x[i], c->y[j] - c->y[i], c->size[i], c->rect[i] != 0, c->size[j], c->rect[j] != 0))
+            PairChunkAdd(out, i, j);
+#endif
+}
+
+static bool CollisionReserveRows(int n){
+    if(n + 4 <= collision.rowCapacity) return true;
+    int cap = collision.rowCapacity ? collision.rowCapacity : 1024;
+    while(cap < n + 4) cap *= 2;   // Padding for the last four-wide load
+    if(!GrowArray((void**)&collision.x, cap, sizeof(float), MEM_COLLISION) ||
+       !GrowArray((void**)&collision.y, cap, sizeof(float), MEM_COLLISION) ||
+       !GrowArray((void**)&collision.size, cap, sizeof(float), MEM_COLLISION) ||
+       !GrowArray((void**)&collision.rect, cap, sizeof(unsigned int), MEM_COLLISION) ||
+       !GrowArray((void**)&collision.row, cap, sizeof(int), MEM_COLLISION)) return false;
+    collision.rowCapacity = cap;
+    return true;
+}
+
+static void PackRow(int k, int i){
+    collision.x[k] = objects.position[i].x;
+    collision.y[k] = objects.position[i].y;
+    collision.size[k] = objects.size[i];
+    collision.rect[k] = objects.shape[i] == SHAPE_RECT ? 0xffffffffu : 0;
+    collision.row[k] = i;
+}
+
+static void CountCellsChunk(void* data, int chunk, int begin, int end){
+    for(int b = begin; b < end; b++){
+        int n = 0;
+        if(grid.cells[b].used) for(int i = grid.cells[b].head; i >= 0; i = objects.gridNext[i]) n++;
+        collision.cellCount[b] = n;
+    }
+}
+
+static void PackCellsChunk(void* data, int chunk, int begin, int end){
+    float maxSize = 0;
+    for(int b = begin; b < end; b++){
+        if(collision.cellCount[b] == 0) continue;
+        int k = collision.cellStart[b];
+        for(int i = grid.cells[b].head; i >= 0; i = objects.gridNext[i], k++){
+            PackRow(k, i);
+            if(objects.size[i] > maxSize) maxSize = objects.size[i];
+        }
+    }
+    chunkMaxSize[chunk] = maxSize;
+}
+
+static void CollideCellsChunk(void* data, int chunk, int begin, int end){
+    PairChunk* out = &pairChunks[chunk];
+    out->count = 0;
+    int reach = collision.reach;
+    for(int b = begin; b < end; b++){
+        int n = collision.cellCount[b];
+        if(n == 0) continue;
+        int first = collision.cellStart[b];
+        for(int k = first; k < first + n; k++) CollideRow(out, k, k+1, first + n - (k+1));
+        // Forward half of the neighborhood, so each cell pair is visited once
+        for(int dy = 0; dy <= reach; dy++){
+            for(int dx = -reach; dx <= reach; dx++){
+                if(dy == 0 && dx <= 0) continue;
+                int nb = GridFindCell(grid.cells[b].cx + dx, grid.cells[b].cy + dy);
+                if(nb < 0 || collision.cellCount[nb] == 0) continue;
+                for(int k = first; k < first + n; k++) CollideRow(out, k, collision.cellStart[nb], collision.cellCount[nb]);
+            }
+        }
+    }
+}
+
+// Side-list objects against the cells they can reach and against each other
+static void CollideLargeObjects(PairChunk* out, float maxSize){
+    for(int k = collision.largeStart; k < collision.largeStart + collision.largeCount; k++){
+        float r = collision.size[k] + maxSize;
+        int x0 = GridCoord(collision.x[k] - r), x1 = GridCoord(collision.x[k] + r);
+        int y0 = GridCoord(collision.y[k] - r), y1 = GridCoord(collision.y[k] + r);
+        if((long long)(x1 - x0 + 1) * (y1 - y0 + 1) > grid.used){
+            for(int b = 0; b < grid.capacity; b++)
+                if(collision.cellCount[b] > 0) CollideRow(out, k, collision.cellStart[b], collision.cellCount[b]);
+        } else {
+            for(int y = y0; y <= y1; y++){
+                for(int x = x0; x <= x1; x++){
+                    int b = GridFindCell(x, y);
+                    if(b >= 0 && collision.cellCount[b] > 0) CollideRow(out, k, collision.cellStart[b], collision.cellCount[b]);
+                }
+            }
+        }
+        CollideRow(out, k, k+1, collision.largeStart + collision.largeCount - (k+1));
+    }
+}
+
+static bool CollisionReserveSlots(void){
+    if(objects.slotCapacity <= collision.contactCapacity) return true;
+    int cap = objects.slotCapacity;
+    if(!GrowArray((void**)&collision.contacts, cap, sizeof(int), MEM_COLLISION) ||
+       !GrowArray((void**)&collision.contactOwner, cap, sizeof(ObjectHandle), MEM_COLLISION)) return false;
+    memset(collision.contactOwner + collision.contactCapacity, 0, (size_t)(cap - collision.contactCapacity) * sizeof(ObjectHandle));
+    collision.contactCapacity = cap;
+    return true;
+}
+
+static void AddCollisionEvent(ObjectHandle a, ObjectHandle b, bool began){
+    if(collision.eventCount == collision.eventCapacity){
+        int cap = collision.eventCapacity ? collision.eventCapacity*2 : 256;
+        if(!GrowArray((void**)&collision.events, cap, sizeof(CollisionEvent), MEM_COLLISION)) return;
+        collision.eventCapacity = cap;
+    }
+    collision.events[collision.eventCount++] = (CollisionEvent){ a, b, began };
+}
+
+// Finds every overlapping pair and the pairs that began or ended since the last pass
+static void DetectCollisions(void){
+    double start = NowSeconds();
+    CollisionWorld* c = &collision;
+    // Per-cell arrays follow the grid's table both ways, so the scans below
+    // cost what the occupied area does, not the largest it has ever been
+    if(grid.capacity > c->cellCapacity || (grid.capacity > 0 && grid.capacity*4 <= c->cellCapacity)){
+        if(!GrowArray((void**)&c->cellStart, grid.capacity, sizeof(int), MEM_COLLISION)) return;
+        if(grid.capacity < c->cellCapacity) c->cellCapacity = grid.capacity; // cellStart already shrank
+        if(!GrowArray((void**)&c->cellCount, grid.capacity, sizeof(int), MEM_COLLISION)) return;
+        c->cellCapacity = grid.capacity;
+    }
+    if(!CollisionReserveRows(objects.count) || !CollisionReserveSlots()) return;
+
+    // Pack: count per cell, offsets, then copy rows
+    ParallelFor(grid.capacity, 1024, CountCellsChunk, NULL);
+    int rows = 0;
+    for(int b = 0; b < grid.capacity; b++){ c->cellStart[b] = rows; rows += c->cellCount[b]; }
+    int chunks = ParallelFor(grid.capacity, 1024, PackCellsChunk, NULL);
+    float maxSize = 0;
+    for(int k = 0; k < chunks; k++) if(chunkMaxSize[k] > maxSize) maxSize = chunkMaxSize[k];
+    c->largeStart = rows;
+    for(int i = grid.largeHead; i >= 0; i = objects.gridNext[i]) PackRow(rows++, i);
+    c->largeCount = rows - c->largeStart;
+    memset(c->x + rows, 0, 4*sizeof(float)); memset(c->y + rows, 0, 4*sizeof(float));
+    memset(c->size + rows, 0, 4*sizeof(float)); memset(c->rect + rows, 0, 4*sizeof(unsigned int));
+    c->reach = 2*maxSize > GRID_CELL ? 2 : 1;
+
+    // Test, then merge chunk results in order, side-list pairs last
+    chunks = ParallelFor(grid.capacity, 256, CollideCellsChunk, NULL);
+    largePairs.count = 0;
+    CollideLargeObjects(&largePairs, maxSize);
+
+    CollisionPair* t = c->previous; c->previous = c->pairs; c->pairs = t;
+    int tc = c->previousCapacity; c->previousCapacity = c->pairCapacity; c->pairCapacity = tc;
+    c->previousCount = c->pairCount;
+    unsigned long long* ts = c->previousSet; c->previousSet = c->set; c->set = ts;
+    tc = c->previousSetCapacity; c->previousSetCapacity = c->setCapacity; c->setCapacity = tc;
+
+    int n = largePairs.count / 2;
+    for(int k = 0; k < chunks; k++) n += pairChunks[k].count / 2;
+    if(n > c->pairCapacity){
+        if(GrowArray((void**)&c->pairs, n, sizeof(CollisionPair), MEM_COLLISION)) c->pairCapacity = n;
+        else n = c->pairCapacity;
+    }
+    c->pairCount = 0;
+    for(int k = 0; k <= chunks; k++){
+        const PairChunk* chunk = k < chunks ? &pairChunks[k] : &largePairs;
+        for(int e = 0; e < chunk->count && c->pairCount < n; e += 2){
+            int i = c->row[chunk->rows[e]], j = c->row[chunk->rows[e+1]];
+            if(i > j){ int s = i; i = j; j = s; }
+            c->pairs[c->pairCount++] = (CollisionPair){ objects.handle[i], objects.handle[j] };
+        }
+    }
+    if(!PairSetBuild(&c->set, &c->setCapacity, c->pairs, c->pairCount)) c->pairCount = 0;
+
+    // Events and per-object counts; only objects of the last two passes can hold a count
+    c->eventCount = 0;
+    for(int k = 0; k < c->previousCount; k++){
+        CollisionPair p = c->previous[k];
+        if(!PairSetHas(c->set, c->setCapacity, PairKey(p.a, p.b))) AddCollisionEvent(p.a, p.b, false);
+        c->contacts[(p.a & HANDLE_SLOT_MASK) - 1] = 0;
+        c->contacts[(p.b & HANDLE_SLOT_MASK) - 1] = 0;
+    }
+    for(int k = 0; k < c->pairCount; k++){
+        CollisionPair p = c->pairs[k];
+        if(!PairSetHas(c->previousSet, c->previousSetCapacity, PairKey(p.a, p.b))) AddCollisionEvent(p.a, p.b, true);
+        for(int s = 0; s < 2; s++){
+            ObjectHandle h = s ? p.b : p.a;
+            int slot = (h & HANDLE_SLOT_MASK) - 1;
+            if(c->contactOwner[slot] != h){ c->contactOwner[slot] = h; c->contacts[slot] = 0; }
+            c->contacts[slot]++;
+        }
+    }
+    c->passTime = NowSeconds() - start;
+}
+
+// Detection starts the first time anything asks for collisions
+static void EnableCollisions(void){
+    if(collision.enabled) return;
+    collision.enabled = true;
+    DetectCollisions();
+}
+
+static void DisableCollisions(void){
+    collision.enabled = false;
+    collision.pairCount = collision.previousCount = collision.eventCount = 0;
+    if(collision.set) memset(collision.set, 0, (size_t)collision.setCapacity * sizeof(unsigned long long));
+    if(collision.contactOwner) memset(collision.contactOwner, 0, (size_t)collision.contactCapacity * sizeof(ObjectHandle));
+}
+
+// Queries by dense index, as of the last pass
+static bool CollisionTouching(int i, int j){
+    if(i < 0 || j < 0) return false;
+    EnableCollisions();
+    return PairSetHas(collision.set, collision.setCapacity, PairKey(objects.handle[i], objects.handle[j]));
+}
+
+// Touching now but not in the pass before
+static bool CollisionBegan(int i, int j){
+    if(!CollisionTouching(i, j)) return false;
+    return !PairSetHas(collision.previousSet, collision.previousSetCapacity, PairKey(objects.handle[i], objects.handle[j]));
+}
+
+static int CollisionContacts(int i){
+    if(i < 0) return 0;
+    EnableCollisions();
+    ObjectHandle h = objects.handle[i];
+    int slot = (h & HANDLE_SLOT_MASK) - 1;
+    return slot < collision.contactCapacity && collision.contactOwner[slot] == h ? collision.contacts[slot] : 0;
+}
+
+// --- Motion ---
+// Velocity, acceleration and damping live in their own columns and are
+// integrated for every object once per tick in one streaming pass:
+// v = (v + a*dt) / (1 + damping*dt), then p += v*dt. The pass runs in
+// chunks on the job pool with the widest kernel the CPU has (AVX2, picked
+// at runtime, else SSE2, else scalar); every kernel does the same float
+// operations per object, rest test included (a NaN speed snaps to 0 in
+// all of them), so results don't depend on the kernel or thread count.
+// Integrated positions skip the journal (see objects.motionUnsaved).
+// Kernels report whether anything is still in motion, so the pass stops
+// once every object has come to rest.
+#define MOTION_REST 1e-4f   // Speeds below this snap to 0, so damped objects come to rest
+#define MOTION_ACTIVE 1     // Kernel result: some velocity or acceleration is non-zero
+#define MOTION_MOVED 2      // Kernel result: some position changed
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MOTION_AVX2 1
+#endif
+
+static int IntegrateScalar(int begin, int end, float dt){
+    int state = 0;
+    for(int i = begin; i < end; i++){
+        float k = 1.0f + (objects.damping[i] > 0 ? objects.damping[i] : 0)*dt; // Views can write anything
+        Vector2 v = objects.velocity[i], a = objects.acceleration[i];
+        v.x = (v.x + a.x*dt) / k; v.y = (v.y + a.y*dt) / k;
+        if(!(fabsf(v.x) >= MOTION_REST)) v.x = 0; // Written like the SIMD compare, so NaN snaps to 0 too
+        if(!(fabsf(v.y) >= MOTION_REST)) v.y = 0;
+        objects.velocity[i] = v;
+        Vector2 p = objects.position[i];
+        objects.position[i].x += v.x*dt; objects.position[i].y += v.y*dt;
+        if(v.x != 0 || v.y != 0 || a.x != 0 || a.y != 0) state |= MOTION_ACTIVE;
+        if(objects.position[i].x != p.x || objects.position[i].y != p.y) state |= MOTION_MOVED;
+    }
+    return state;
+}
+
+#if defined(__SSE2__)
+// Two objects per register: x0 y0 x1 y1
+static int IntegrateSSE2(int begin, int end, float dt){
+    const __m128 vdt = _mm_set1_ps(dt), one = _mm_set1_ps(1.0f), rest = _mm_set1_ps(MOTION_REST);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)), zero = _mm_setzero_ps();
+    __m128 active = zero, moved = zero;
+    int i = begin;
+    for(; i + 2 <= end; i += 2){
+        __m128 d = _mm_castpd_ps(_mm_load_sd((const double*)(objects.damping + i)));
+        d = _mm_max_ps(_mm_unpacklo_ps(d, d), _mm_setzero_ps());
+        __m128 k = _mm_add_ps(one, _mm_mul_ps(d, vdt));
+        __m128 v = _mm_loadu_ps(&objects.velocity[i].x), a = _mm_loadu_ps(&objects.acceleration[i].x);
+        v = _mm_div_ps(_mm_add_ps(v, _mm_mul_ps(a, vdt)), k);
+        v = _mm_and_ps(v, _mm_cmpge_ps(_mm_and_ps(v, absMask), rest));
+        _mm_storeu_ps(&objects.velocity[i].x, v);
+        __m128 p = _mm_loadu_ps(&objects.position[i].x), np = _mm_add_ps(p, _mm_mul_ps(v, vdt));
+        _mm_storeu_ps(&objects.position[i].x, np);
+        active = _mm_or_ps(active, _mm_or_ps(_mm_cmpneq_ps(v, zero), _mm_cmpneq_ps(a, zero)));
+        moved = _mm_or_ps(moved, _mm_cmpneq_ps(np, p));
+    }
+    return IntegrateScalar(i, end, dt) | (_mm_movemask_ps(active) ? MOTION_ACTIVE : 0) | (_mm_movemask_ps(moved) ? MOTION_MOVED : 0);
+}
+#endif
+
+#ifdef MOTION_AVX2
+// Four objects per register; damping is spread to both lanes of its object
+__attribute__((target("avx2")))
+static int IntegrateAVX2(int begin, int end, float dt){
+    const __m256 vdt = _mm256_set1_ps(dt), one = _mm256_set1_ps(1.0f), rest = _mm256_set1_ps(MOTION_REST);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)), zero = _mm256_setzero_ps();
+    __m256 active = zero, moved = zero;
+    const __m256i spread = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    int i = begin;
+    for(; i + 4 <= end; i += 4){
+        __m256 d = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(_mm_loadu_ps(objects.damping + i)), spread);
+        d = _mm256_max_ps(d, _mm256_setzero_ps());
+        __m256 k = _mm256_add_ps(one, _mm256_mul_ps(d, vdt));
+        __m256 v = _mm256_loadu_ps(&objects.velocity[i].x), a = _mm256_loadu_ps(&objects.acceleration[i].x);
+        v = _mm256_div_ps(_mm256_add_ps(v, _mm256_mul_ps(a, vdt)), k);
+        v = _mm256_and_ps(v, _mm256_cmp_ps(_mm256_and_ps(v, absMask), rest, _CMP_GE_OQ));
+        _mm256_storeu_ps(&objects.velocity[i].x, v);
+        __m256 p = _mm256_loadu_ps(&objects.position[i].x), np = _mm256_add_ps(p, _mm256_mul_ps(v, vdt));
+        _mm256_storeu_ps(&objects.position[i].x, np);
+        active = _mm256_or_ps(active, _mm256_or_ps(_mm256_cmp_ps(v, zero, _CMP_NEQ_UQ), _mm256_cmp_ps(a, zero, _CMP_NEQ_UQ)));
+        moved = _mm256_or_ps(moved, _mm256_cmp_ps(np, p, _CMP_NEQ_UQ));
+    }
+    return IntegrateScalar(i, end, dt) | (_mm256_movemask_ps(active) ? MOTION_ACTIVE : 0) | (_mm256_movemask_ps(moved) ? MOTION_MOVED : 0);
+}
+#endif
+
+typedef int (*IntegrateKernel)(int begin, int end, float dt);
+static unsigned char motionChunkState[JOB_MAX_CHUNKS];
+static IntegrateKernel integrateKernel = NULL;
+static const char* integrateKernelName = "scalar";
+
+static void SelectIntegrateKernel(void){
+    integrateKernel = IntegrateScalar;
+#if defined(__SSE2__)
+    integrateKernel = IntegrateSSE2; integrateKernelName = "sse2";
+#endif
+#ifdef MOTION_AVX2
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){ integrateKernel = IntegrateAVX2; integrateKernelName = "avx2"; }
+#endif
+}
+
+static void IntegrateChunk(void* data, int chunk, int begin, int end){
+    motionChunkState[chunk] = (unsigned char)integrateKernel(begin, end, *(const float*)data);
+}
+
+// Moves every object by its velocity; refiles the ones that changed grid
+// cell. Stops integrating once nothing moves; live velocity or acceleration
+// views may still be written, so they keep it going.
+static void IntegrateMotion(float dt){
+    if(!objects.moving || objects.count == 0) return;
+    if(!integrateKernel) SelectIntegrateKernel();
+    int chunks = ParallelFor(objects.count, 16384, IntegrateChunk, &dt);
+    int state = 0;
+    for(int k = 0; k < chunks; k++) state |= motionChunkState[k];
+    if(state & MOTION_MOVED){
+        GridRefresh(NULL, objects.count);
+        objects.motionUnsaved = true;
+    }
+    if(!(state & MOTION_ACTIVE) && objects.viewExports == 0) objects.moving = false;
+}
+
+static void SetObjectVelocity(int i, Vector2 v){
+    objects.velocity[i] = v;
+    if(v.x != 0 || v.y != 0) objects.moving = true;
+}
+
+static void SetObjectAcceleration(int i, Vector2 a){
+    objects.acceleration[i] = a;
+    if(a.x != 0 || a.y != 0) objects.moving = true;
+}
+
+static void SetObjectDamping(int i, float d){ objects.damping[i] = d > 0 ? d : 0; }
+
+// --- Python game module ---
+// Native bindings: every call mutates or reads the object store directly.
+// Objects can be passed by name or by integer handle.
+static int PyObjectArg(PyObject* ref){
+    if(PyLong_Check(ref)) return ObjectIndex((ObjectHandle)PyLong_AsUnsignedLongMask(ref));
+    if(PyUnicode_Check(ref)){
+        const char* name = PyUnicode_AsUTF8(ref);
+        return name ? ResolveObject(name) : -1;
+    }
+    PyErr_SetString(PyExc_TypeError, "object must be a name or a handle");
+    return -1;
+}
+
+// Mutators log a missing object like the console does and return False
+static int PyTargetObject(PyObject* ref){
+    int i = PyObjectArg(ref);
+    if(i < 0 && !PyErr_Occurred()){
+        PyObject* text = PyObject_Str(ref);
+        AddLog("Error: '%s' not found", text ? PyUnicode_AsUTF8(text) : "?");
+        Py_XDECREF(text);
+    }
+    return i;
+}
+
+static PyObject* Py_move_object(PyObject* self, PyObject* args){
+    PyObject* ref; float dx, dy;
+    if(!PyArg_ParseTuple(args, "Off:move_object", &ref, &dx, &dy)) return NULL;
+    int i = PyTargetObject(ref);
+    if(PyErr_Occurred()) return NULL;
+    if(i >= 0) SetObjectPosition(i, Vector2Add(objects.position[i], (Vector2){dx, dy}));
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* Py_set_position(PyObject* self, PyObject* args){
+    PyObject* ref; float x, y;
+    if(!PyArg_ParseTuple(args, "Off:set_position", &ref, &x, &y)) return NULL;
+    int i = PyTargetObject(ref);
+    if(PyErr_Occurred()) return NULL;
+    if(i >= 0) SetObjectPosition(i, (Vector2){x, y});
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* Py_set_color(PyObject* self, PyObject* args){
+    PyObject* ref; int r, g, b, a = 255;
+    if(!PyArg_ParseTuple(args, "Oiii|i:set_color", &ref, &r, &g, &b, &a)) return NULL;
+    int i = PyTargetObject(ref);
+    if(PyErr_Occurred()) return NULL;
+    if(i >= 0) SetObjectColor(i, (Color){r, g, b, a});
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* CreateFromPython(PyObject* args, ShapeType shape, const char* format){
+    const char* name; float x, y, size; int r, g, b;
+    if(!PyArg_ParseTuple(args, format, &name, &x, &y, &size, &r, &g, &b)) return NULL;
+    ObjectHandle h = AddObject(name, shape, (Vector2){x, y}, size, (Color){r, g, b, 255});
+    if(h == INVALID_HANDLE && objects.viewExports > 0 && objects.count == objects.capacity){
+        PyErr_SetString(PyExc_BufferError, "release game views (or call game.reserve) before creating objects");
+        return NULL;
+    }
+    if(h == INVALID_HANDLE) Py_RETURN_NONE;
+    return PyLong_FromUnsignedLong(h);
+}
+
+static PyObject* Py_create_circle(PyObject* self, PyObject* args){ return CreateFromPython(args, SHAPE_CIRCLE, "sfffiii:create_circle"); }
+static PyObject* Py_create_rect(PyObject* self, PyObject* args){ return CreateFromPython(args, SHAPE_RECT, "sfffiii:create_rect"); }
+
+static PyObject* Py_delete_obj(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:delete_obj", &ref)) return NULL;
+    int i = PyTargetObject(ref);
+    if(PyErr_Occurred()) return NULL;
+    if(i >= 0 && objects.viewExports > 0){
+        PyErr_SetString(PyExc_BufferError, "release game views before deleting objects");
+        return NULL;
+    }
+    if(i >= 0){
+        char key[NAME_LEN + 16];
+        snprintf(key, sizeof(key), "#%u", objects.handle[i]);
+        DeleteObject(key);
+    }
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* Py_get_position(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:get_position", &ref)) return NULL;
+    int i = PyObjectArg(ref);
+    if(i < 0){ if(PyErr_Occurred()) return NULL; Py_RETURN_NONE; }
+    return Py_BuildValue("(ff)", objects.position[i].x, objects.position[i].y);
+}
+
+static PyObject* Py_get_color(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:get_color", &ref)) return NULL;
+    int i = PyObjectArg(ref);
+    if(i < 0){ if(PyErr_Occurred()) return NULL; Py_RETURN_NONE; }
+    Color c = objects.color[i];
+    return Py_BuildValue("(iiii)", c.r, c.g, c.b, c.a);
+}
+
+static PyObject* Py_set_velocity(PyObject* self, PyObject* args){
+    PyObject* ref; float x, y;
+    if(!PyArg_ParseTuple(args, "Off:set_velocity", &ref, &x, &y)) return NULL;
+    int i = PyTargetObject(ref);
+    if(PyErr_Occurred()) return NULL;
+    if(i >= 0) SetObjectVelocity(i, (Vector2){x, y});
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* Py_set_acceleration(PyObject* self, PyObject* args){
+    PyObject* ref; float x, y;
+    if(!PyArg_ParseTuple(args, "Off:set_acceleration", &ref, &x, &y)) return NULL;
+    int i = PyTargetObject(ref);
+    if(PyErr_Occurred()) return NULL;
+    if(i >= 0) SetObjectAcceleration(i, (Vector2){x, y});
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* Py_set_damping(PyObject* self, PyObject* args){
+    PyObject* ref; float d;
+    if(!PyArg_ParseTuple(args, "Of:set_damping", &ref, &d)) return NULL;
+    int i = PyTargetObject(ref);
+    if(PyErr_Occurred()) return NULL;
+    if(i >= 0) SetObjectDamping(i, d);
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* Py_get_velocity(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:get_velocity", &ref)) return NULL;
+    int i = PyObjectArg(ref);
+    if(i < 0){ if(PyErr_Occurred()) return NULL; Py_RETURN_NONE; }
+    return Py_BuildValue("(ff)", objects.velocity[i].x, objects.velocity[i].y);
+}
+
+static PyObject* Py_get_size(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:get_size", &ref)) return NULL;
+    int i = PyObjectArg(ref);
+    if(i < 0){ if(PyErr_Occurred()) return NULL; Py_RETURN_NONE; }
+    return PyFloat_FromDouble(objects.size[i]);
+}
+
+static PyObject* Py_exists(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:exists", &ref)) return NULL;
+    int i = PyObjectArg(ref);
+    if(PyErr_Occurred()) return NULL;
+    return PyBool_FromLong(i >= 0);
+}
+
+static PyObject* Py_find_object(PyObject* self, PyObject* args){
+    const char* name;
+    if(!PyArg_ParseTuple(args, "s:find_object", &name)) return NULL;
+    int i = ResolveObject(name);
+    if(i < 0) Py_RETURN_NONE;
+    return PyLong_FromUnsignedLong(objects.handle[i]);
+}
+
+static PyObject* Py_object_at(PyObject* self, PyObject* args){
+    float x, y;
+    if(!PyArg_ParseTuple(args, "ff:object_at", &x, &y)) return NULL;
+    int i = PickObject((Vector2){x, y});
+    if(i < 0) Py_RETURN_NONE;
+    return PyLong_FromUnsignedLong(objects.handle[i]);
+}
+
+static PyObject* Py_object_count(PyObject* self, PyObject* noargs){
+    return PyLong_FromLong(objects.count);
+}
+
+static PyObject* Py_touching(PyObject* self, PyObject* args){
+    PyObject *a, *b;
+    if(!PyArg_ParseTuple(args, "OO:touching", &a, &b)) return NULL;
+    int i = PyObjectArg(a);
+    int j = PyErr_Occurred() ? -1 : PyObjectArg(b);
+    if(PyErr_Occurred()) return NULL;
+    return PyBool_FromLong(CollisionTouching(i, j));
+}
+
+static PyObject* Py_contacts(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:contacts", &ref)) return NULL;
+    int i = PyObjectArg(ref);
+    if(PyErr_Occurred()) return NULL;
+    return PyLong_FromLong(CollisionContacts(i));
+}
+
+static PyObject* Py_collision_pairs(PyObject* self, PyObject* noargs){
+    EnableCollisions();
+    PyObject* list = PyList_New(collision.pairCount);
+    if(!list) return NULL;
+    for(int k = 0; k < collision.pairCount; k++){
+        PyObject* pair = Py_BuildValue("(II)", collision.pairs[k].a, collision.pairs[k].b);
+        if(!pair){ Py_DECREF(list); return NULL; }
+        PyList_SET_ITEM(list, k, pair);
+    }
+    return list;
+}
+
+static PyObject* Py_collision_events(PyObject* self, PyObject* noargs){
+    EnableCollisions();
+    PyObject* list = PyList_New(collision.eventCount);
+    if(!list) return NULL;
+    for(int k = 0; k < collision.eventCount; k++){
+        const CollisionEvent* e = &collision.events[k];
+        PyObject* event = Py_BuildValue("(IIO)", e->a, e->b, e->began ? Py_True : Py_False);
+        if(!event){ Py_DECREF(list); return NULL; }
+        PyList_SET_ITEM(list, k, event);
+    }
+    return list;
+}
+
+// Variables can be passed by name or by a slot from variable_slot()
+static int PyVariableArg(PyObject* ref, int* component){
+    *component = 0;
+    if(PyLong_Check(ref)){
+        long slot = PyLong_AsLong(ref);
+        if(slot < 0 || slot >= variableCount){ PyErr_SetString(PyExc_IndexError, "bad variable slot"); return -1; }
+        return (int)slot;
+    }
+    if(PyUnicode_Check(ref)){
+        const char* name = PyUnicode_AsUTF8(ref);
+        if(!name) return -1;
+        char base[NAME_LEN];
+        *component = ParseVariableRef(name, base);
+        int slot = InternVariable(base);
+        if(slot < 0) PyErr_NoMemory();
+        return slot;
+    }
+    PyErr_SetString(PyExc_TypeError, "variable must be a name or a slot");
+    return -1;
+}
+
+static PyObject* Py_variable_slot(PyObject* self, PyObject* args){
+    PyObject* ref; int component;
+    if(!PyArg_ParseTuple(args, "U:variable_slot", &ref)) return NULL;
+    int slot = PyVariableArg(ref, &component);
+    if(slot < 0) return NULL;
+    return PyLong_FromLong(slot);
+}
+
+static PyObject* Py_get_variable(PyObject* self, PyObject* args){
+    PyObject* ref; int component;
+    if(!PyArg_ParseTuple(args, "O:get_variable", &ref)) return NULL;
+    int slot = PyVariableArg(ref, &component);
+    if(slot < 0) return NULL;
+    const Variable* v = &variables[slot];
+    if(component == 0){
+        if(v->type == VAR_INT) return PyLong_FromLong(v->value.i);
+        if(v->type == VAR_VEC2) return Py_BuildValue("(ff)", v->value.v.x, v->value.v.y);
+        if(v->type == VAR_COLOR) return Py_BuildValue("(iiii)", v->value.c.r, v->value.c.g, v->value.c.b, v->value.c.a);
+    }
+    return PyFloat_FromDouble(VariableValue(slot, component));
+}
+
+static PyObject* Py_set_variable(PyObject* self, PyObject* args){
+    PyObject* ref; PyObject* value; int component;
+    if(!PyArg_ParseTuple(args, "OO:set_variable", &ref, &value)) return NULL;
+    int slot = PyVariableArg(ref, &component);
+    if(slot < 0) return NULL;
+    Variable* v = &variables[slot];
+    if(PyTuple_Check(value) && component == 0){
+        Py_ssize_t n = PyTuple_Size(value);
+        float f[4] = {0, 0, 0, 255};
+        if(n < 2 || n > 4){ PyErr_SetString(PyExc_ValueError, "expected (x, y) or (r, g, b[, a])"); return NULL; }
+        for(Py_ssize_t k = 0; k < n; k++){
+            f[k] = (float)PyFloat_AsDouble(PyTuple_GetItem(value, k));
+            if(PyErr_Occurred()) return NULL;
+        }
+        v->defined = true;
+        if(n == 2){ v->type = VAR_VEC2; v->value.v = (Vector2){f[0], f[1]}; }
+        else {
+            v->type = VAR_COLOR;
+            v->value.c = (Color){(unsigned char)Clamp(f[0],0,255), (unsigned char)Clamp(f[1],0,255), (unsigned char)Clamp(f[2],0,255), (unsigned char)Clamp(f[3],0,255)};
+        }
+        JournalVariableChanged(slot);
+        Py_RETURN_NONE;
+    }
+    double d = PyFloat_AsDouble(value);
+    if(PyErr_Occurred()) return NULL;
+    if(PyLong_Check(value) && component == 0 && !v->defined) v->type = VAR_INT;
+    SetVariableValue(slot, component, (float)d);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Py_log_message(PyObject* self, PyObject* args){
+    PyObject* msg;
+    if(!PyArg_ParseTuple(args, "O:log_message", &msg)) return NULL;
+    PyObject* text = PyObject_Str(msg);
+    if(!text) return NULL;
+    const char* utf8 = PyUnicode_AsUTF8(text);
+    if(utf8) LogMessage(LOG_INFO, LOG_PYTHON, "[Python] %s", utf8);
+    Py_DECREF(text);
+    Py_RETURN_NONE;
+}
+
+// Zero-copy views of the object columns. Each export pins the columns
+// (the store refuses to grow until every view is released), so scripts
+// should use "with game.positions() as pos:" or drop views before adding
+// objects; game.reserve(n) grows the store up front.
+typedef enum {
+    COLUMN_POSITIONS, COLUMN_SIZES, COLUMN_COLORS, COLUMN_HANDLES,
+    COLUMN_VELOCITIES, COLUMN_ACCELERATIONS, COLUMN_DAMPING
+} ObjectColumnKind;
+
+typedef struct {
+    PyObject_HEAD
+    int column;
+} ObjectColumnObject;
+
+static int ObjectColumn_getbuffer(PyObject* self, Py_buffer* view, int flags){
+    int column = ((ObjectColumnObject*)self)->column;
+    if(column == COLUMN_HANDLES && (flags & PyBUF_WRITABLE)){
+        PyErr_SetString(PyExc_BufferError, "handles are read-only");
+        return -1;
+    }
+    Py_ssize_t* dims = PyMem_Malloc(4 * sizeof(Py_ssize_t)); // shape[2], strides[2]
+    if(!dims){ PyErr_NoMemory(); return -1; }
+    Py_ssize_t n = objects.count;
+    view->ndim = 1;
+    dims[0] = n;
+    switch(column){
+        case COLUMN_POSITIONS:
+        case COLUMN_VELOCITIES:
+        case COLUMN_ACCELERATIONS:
+            view->buf = column == COLUMN_POSITIONS ? objects.position : column == COLUMN_VELOCITIES ? objects.velocity : objects.acceleration;
+            view->itemsize = sizeof(float); view->format = "f";
+            view->ndim = 2; dims[1] = 2; dims[2] = sizeof(Vector2); dims[3] = sizeof(float);
+            // Writes through the view aren't seen one by one; integrate from now on
+            if(column != COLUMN_POSITIONS) objects.moving = true;
+            break;
+        case COLUMN_DAMPING:
+            view->buf = objects.damping; view->itemsize = sizeof(float); view->format = "f";
+            dims[2] = sizeof(float);
+            break;
+        case COLUMN_SIZES:
+            view->buf = objects.size; view->itemsize = sizeof(float); view->format = "f";
+            dims[2] = sizeof(float);
+            break;
+        case COLUMN_COLORS:
+            view->buf = objects.color; view->itemsize = 1; view->format = "B";
+            view->ndim = 2; dims[1] = 4; dims[2] = sizeof(Color); dims[3] = 1;
+            break;
+        default:
+            view->buf = objects.handle; view->itemsize = sizeof(ObjectHandle); view->format = "I";
+            dims[2] = sizeof(ObjectHandle);
+            break;
+    }
+    view->obj = Py_NewRef(self);
+    view->readonly = (column == COLUMN_HANDLES);
+    view->len = n * (view->ndim == 2 ? dims[1] : 1) * view->itemsize;
+    view->shape = dims;
+    view->strides = dims + 2;
+    view->suboffsets = NULL;
+    view->internal = dims;
+    if(!(flags & PyBUF_FORMAT)) view->format = NULL;
+    objects.viewExports++;
+    return 0;
+}
+
+static void ObjectColumn_releasebuffer(PyObject* self, Py_buffer* view){
+    PyMem_Free(view->internal);
+    objects.viewExports--;
+}
+
+static PyBufferProcs ObjectColumnBuffer = {
+    .bf_getbuffer = ObjectColumn_getbuffer,
+    .bf_releasebuffer = ObjectColumn_releasebuffer,
+};
+
+static PyTypeObject ObjectColumnType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "game.ObjectColumn",
+    .tp_basicsize = sizeof(ObjectColumnObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Buffer over one column of the engine's object store",
+    .tp_as_buffer = &ObjectColumnBuffer,
+};
+
+static PyObject* ColumnView(int column){
+    ObjectColumnObject* col = PyObject_New(ObjectColumnObject, &ObjectColumnType);
+    if(!col) return NULL;
+    col->column = column;
+    PyObject* view = PyMemoryView_FromObject((PyObject*)col);
+    Py_DECREF(col);
+    return view;
+}
+
+static PyObject* Py_positions(PyObject* self, PyObject* noargs){ return ColumnView(COLUMN_POSITIONS); }
+static PyObject* Py_sizes(PyObject* self, PyObject* noargs){ return ColumnView(COLUMN_SIZES); }
+static PyObject* Py_colors(PyObject* self, PyObject* noargs){ return ColumnView(COLUMN_COLORS); }
+static PyObject* Py_handles(PyObject* self, PyObject* noargs){ return ColumnView(COLUMN_HANDLES); }
+static PyObject* Py_velocities(PyObject* self, PyObject* noargs){ return ColumnView(COLUMN_VELOCITIES); }
+static PyObject* Py_accelerations(PyObject* self, PyObject* noargs){ return ColumnView(COLUMN_ACCELERATIONS); }
+static PyObject* Py_damping(PyObject* self, PyObject* noargs){ return ColumnView(COLUMN_DAMPING); }
+
+static PyObject* Py_names(PyObject* self, PyObject* noargs){
+    PyObject* list = PyList_New(objects.count);
+    if(!list) return NULL;
+    for(int i = 0; i < objects.count; i++){
+        PyObject* name = PyUnicode_FromString(objects.name[i]);
+        if(!name){ Py_DECREF(list); return NULL; }
+        PyList_SET_ITEM(list, i, name);
+    }
+    return list;
+}
+
+static PyObject* Py_index_of(PyObject* self, PyObject* args){
+    PyObject* ref;
+    if(!PyArg_ParseTuple(args, "O:index_of", &ref)) return NULL;
+    int i = PyObjectArg(ref);
+    if(i < 0){ if(PyErr_Occurred()) return NULL; Py_RETURN_NONE; }
+    return PyLong_FromLong(i);
+}
+
+static PyObject* Py_reserve(PyObject* self, PyObject* args){
+    int n;
+    if(!PyArg_ParseTuple(args, "i:reserve", &n)) return NULL;
+    if(!ObjectStoreReserve(n) || !NameIndexReserve(n)){
+        PyErr_SetString(PyExc_BufferError, "cannot grow the object store while views are exported");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// commit() marks every object changed; commit(indices) only those dense indices
+static PyObject* Py_commit(PyObject* self, PyObject* args){
+    PyObject* indices = NULL;
+    if(!PyArg_ParseTuple(args, "|O:commit", &indices)) return NULL;
+    int marked = 0;
+    if(!indices || indices == Py_None){
+        for(int i = 0; i < objects.count; i++) MarkObjectDirty(i);
+        marked = objects.count;
+    } else {
+        PyObject* it = PyObject_GetIter(indices);
+        if(!it) return NULL;
+        PyObject* item;
+        while((item = PyIter_Next(it))){
+            long i = PyLong_AsLong(item);
+            Py_DECREF(item);
+            if(i == -1 && PyErr_Occurred()) break;
+            if(i < 0 || i >= objects.count){ PyErr_Format(PyExc_IndexError, "object index %ld out of range", i); break; }
+            MarkObjectDirty((int)i);
+            marked++;
+        }
+        Py_DECREF(it);
+        if(PyErr_Occurred()) return NULL;
+    }
+    return PyLong_FromLong(marked);
+}
+
+// game.objects: read-only name -> handle mapping answered from the name
+// index, so adding, deleting or loading objects costs Python nothing
+typedef struct {
+    PyObject_HEAD
+} ObjectMapObject;
+
+static Py_ssize_t ObjectMap_length(PyObject* self){ return objects.count; }
+
+static PyObject* ObjectMap_lookup(PyObject* key, bool raise){
+    const char* name = PyUnicode_Check(key) ? PyUnicode_AsUTF8(key) : NULL;
+    ObjectHandle h = name ? FindHandle(name) : INVALID_HANDLE;
+    if(h != INVALID_HANDLE) return PyLong_FromUnsignedLong(h);
+    if(PyErr_Occurred()) return NULL;
+    if(raise) PyErr_SetObject(PyExc_KeyError, key);
+    return NULL;
+}
+
+static PyObject* ObjectMap_subscript(PyObject* self, PyObject* key){ return ObjectMap_lookup(key, true); }
+
+static int ObjectMap_contains(PyObject* self, PyObject* key){
+    PyObject* h = ObjectMap_lookup(key, false);
+    if(!h) return PyErr_Occurred() ? -1 : 0;
+    Py_DECREF(h);
+    return 1;
+}
+
+static PyObject* Py_names(PyObject* self, PyObject* noargs);
+
+static PyObject* ObjectMap_iter(PyObject* self){
+    PyObject* names = Py_names(NULL, NULL);
+    if(!names) return NULL;
+    PyObject* it = PyObject_GetIter(names);
+    Py_DECREF(names);
+    return it;
+}
+
+static PyObject* ObjectMap_get(PyObject* self, PyObject* args){
+    PyObject* key; PyObject* fallback = Py_None;
+    if(!PyArg_ParseTuple(args, "O|O:get", &key, &fallback)) return NULL;
+    PyObject* h = ObjectMap_lookup(key, false);
+    if(h || PyErr_Occurred()) return h;
+    return Py_NewRef(fallback);
+}
+
+static PyObject* ObjectMap_values(PyObject* self, PyObject* noargs){
+    PyObject* list = PyList_New(objects.count);
+    for(int i = 0; list && i < objects.count; i++){
+        PyObject* h = PyLong_FromUnsignedLong(objects.handle[i]);
+        if(!h){ Py_CLEAR(list); break; }
+        PyList_SET_ITEM(list, i, h);
+    }
+    return list;
+}
+
+static PyObject* ObjectMap_items(PyObject* self, PyObject* noargs){
+    PyObject* list = PyList_New(objects.count);
+    for(int i = 0; list && i < objects.count; i++){
+        PyObject* item = Py_BuildValue("(sk)", objects.name[i], (unsigned long)objects.handle[i]);
+        if(!item){ Py_CLEAR(list); break; }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+static PyMethodDef ObjectMapMethods[] = {
+    {"get", ObjectMap_get, METH_VARARGS, "get(name[, default]) -> handle"},
+    {"keys", Py_names, METH_NOARGS, "keys() -> list of names"},
+    {"values", ObjectMap_values, METH_NOARGS, "values() -> list of handles"},
+    {"items", ObjectMap_items, METH_NOARGS, "items() -> list of (name, handle)"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyMappingMethods ObjectMapMapping = {
+    .mp_length = ObjectMap_length,
+    .mp_subscript = ObjectMap_subscript,
+};
+
+static PySequenceMethods ObjectMapSequence = {
+    .sq_contains = ObjectMap_contains,
+};
+
+static PyTypeObject ObjectMapType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "game.ObjectMap",
+    .tp_basicsize = sizeof(ObjectMapObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Live mapping of object names to handles",
+    .tp_as_mapping = &ObjectMapMapping,
+    .tp_as_sequence = &ObjectMapSequence,
+    .tp_iter = ObjectMap_iter,
+    .tp_methods = ObjectMapMethods,
+};
+
+static PyMethodDef GameMethods[] = {
+    {"move_object", Py_move_object, METH_VARARGS, "move_object(obj, dx, dy) -> bool"},
+    {"set_position", Py_set_position, METH_VARARGS, "set_position(obj, x, y) -> bool"},
+    {"set_color", Py_set_color, METH_VARARGS, "set_color(obj, r, g, b[, a]) -> bool"},
+    {"create_circle", Py_create_circle, METH_VARARGS, "create_circle(name, x, y, size, r, g, b) -> handle or None"},
+    {"create_rect", Py_create_rect, METH_VARARGS, "create_rect(name, x, y, size, r, g, b) -> handle or None"},
+    {"delete_obj", Py_delete_obj, METH_VARARGS, "delete_obj(obj) -> bool"},
+    {"get_position", Py_get_position, METH_VARARGS, "get_position(obj) -> (x, y) or None"},
+    {"get_color", Py_get_color, METH_VARARGS, "get_color(obj) -> (r, g, b, a) or None"},
+    {"get_size", Py_get_size, METH_VARARGS, "get_size(obj) -> float or None"},
+    {"set_velocity", Py_set_velocity, METH_VARARGS, "set_velocity(obj, vx, vy) -> bool"},
+    {"get_velocity", Py_get_velocity, METH_VARARGS, "get_velocity(obj) -> (vx, vy) or None"},
+    {"set_acceleration", Py_set_acceleration, METH_VARARGS, "set_acceleration(obj, ax, ay) -> bool"},
+    {"set_damping", Py_set_damping, METH_VARARGS, "set_damping(obj, d) -> bool"},
+    {"exists", Py_exists, METH_VARARGS, "exists(obj) -> bool"},
+    {"find_object", Py_find_object, METH_VARARGS, "find_object(name) -> handle or None"},
+    {"object_at", Py_object_at, METH_VARARGS, "object_at(x, y) -> handle of the topmost object there or None"},
+    {"object_count", Py_object_count, METH_NOARGS, "object_count() -> int"},
+    {"touching", Py_touching, METH_VARARGS, "touching(a, b) -> bool, as of the last collision pass"},
+    {"contacts", Py_contacts, METH_VARARGS, "contacts(obj) -> number of objects touching obj"},
+    {"collision_pairs", Py_collision_pairs, METH_NOARGS, "collision_pairs() -> list of (a, b) handles that overlap"},
+    {"collision_events", Py_collision_events, METH_NOARGS, "collision_events() -> list of (a, b, began) from the last pass"},
+    {"variable_slot", Py_variable_slot, METH_VARARGS, "variable_slot(name) -> int"},
+    {"get_variable", Py_get_variable, METH_VARARGS, "get_variable(name_or_slot) -> value"},
+    {"set_variable", Py_set_variable, METH_VARARGS, "set_variable(name_or_slot, value)"},
+    {"log_message", Py_log_message, METH_VARARGS, "log_message(msg)"},
+    {"positions", Py_positions, METH_NOARGS, "positions() -> writable memoryview float32[n][2]"},
+    {"sizes", Py_sizes, METH_NOARGS, "sizes() -> writable memoryview float32[n]"},
+    {"colors", Py_colors, METH_NOARGS, "colors() -> writable memoryview uint8[n][4]"},
+    {"handles", Py_handles, METH_NOARGS, "handles() -> read-only memoryview uint32[n]"},
+    {"velocities", Py_velocities, METH_NOARGS, "velocities() -> writable memoryview float32[n][2]"},
+    {"accelerations", Py_accelerations, METH_NOARGS, "accelerations() -> writable memoryview float32[n][2]"},
+    {"damping", Py_damping, METH_NOARGS, "damping() -> writable memoryview float32[n]"},
+    {"names", Py_names, METH_NOARGS, "names() -> list of names in view order"},
+    {"index_of", Py_index_of, METH_VARARGS, "index_of(obj) -> row in the views or None"},
+    {"reserve", Py_reserve, METH_VARARGS, "reserve(n): grow the store before taking views"},
+    {"commit", Py_commit, METH_VARARGS, "commit([indices]) -> number of objects marked changed"},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef GameModule = {
+    PyModuleDef_HEAD_INIT, "game", "2D Game Engine API", -1, GameMethods,
+    NULL, NULL, NULL, NULL
+};
+
+static PyObject* PyInit_game(void){
+    if(PyType_Ready(&ObjectColumnType) < 0 || PyType_Ready(&ObjectMapType) < 0) return NULL;
+    PyObject* module = PyModule_Create(&GameModule);
+    if(module && PyModule_AddObjectRef(module, "ObjectColumn", (PyObject*)&ObjectColumnType) < 0) Py_CLEAR(module);
+    PyObject* map = module ? PyObject_New(PyObject, &ObjectMapType) : NULL;
+    if(module && (!map || PyModule_AddObject(module, "objects", map) < 0)){ Py_XDECREF(map); Py_CLEAR(module); }
+    return module;
+}
+
+// --- Python code cache ---
+// Compiled code objects per project/file, reused until the file's mtime
+// or size changes or SaveScript rewrites it
+typedef struct {
+    char project[NAME_LEN];
+    char name[NAME_LEN];
+    long long mtime;
+    long size;
+    PyObject* code;
+} PyCodeEntry;
+
+static PyCodeEntry* pyCodeCache = NULL;
+static int pyCodeCount = 0, pyCodeCapacity = 0;
+
+static PyCodeEntry* FindPythonCode(const char* project, const char* name){
+    for(int i = 0; i < pyCodeCount; i++)
+        if(strcmp(pyCodeCache[i].name, name) == 0 && strcmp(pyCodeCache[i].project, project) == 0) return &pyCodeCache[i];
+    return NULL;
+}
+
+static void InvalidatePythonCode(const char* project, const char* name){
+    PyCodeEntry* e = Py_IsInitialized() ? FindPythonCode(project, name) : NULL;
+    if(!e || !e->code) return;
+    PyGILState_STATE gil = PyGILState_Ensure();
+    Py_CLEAR(e->code);
+    PyGILState_Release(gil);
+}
+
+// Returns a borrowed code object for the script, compiling it on a miss
+static PyObject* GetPythonCode(const char* project, const char* name, const char* path){
+    struct stat st;
+    if(stat(path, &st) != 0) return NULL;
+    PyCodeEntry* e = FindPythonCode(project, name);
+    if(e && e->code && e->mtime == FileMTime(&st) && e->size == (long)st.st_size) return e->code;
+
+    long len = 0;
+    char* source = ReadWholeFile(path, &len, NULL);
+    if(!source) return NULL;
+    PyObject* code = Py_CompileString(source, path, Py_file_input);
+    MemFree(source);
+    if(!code) return NULL;
+
+    if(!e){
+        if(pyCodeCount == pyCodeCapacity){
+            int cap = pyCodeCapacity ? pyCodeCapacity*2 : 16;
+            if(!GrowArray((void**)&pyCodeCache, cap, sizeof(PyCodeEntry), MEM_PYTHON)){ Py_DECREF(code); return NULL; }
+            pyCodeCapacity = cap;
+        }
+        e = &pyCodeCache[pyCodeCount++];
+        memset(e, 0, sizeof(*e));
+        strncpy(e->project, project, NAME_LEN-1);
+        strncpy(e->name, name, NAME_LEN-1);
+    }
+    Py_XSETREF(e->code, code);
+    e->mtime = FileMTime(&st);
+    e->size = (long)st.st_size;
+    return code;
+}
+
+// --- Project / Script files ---
+static void CreateDirIfNotExist(const char* path){ MakeDir(path); }
+
+// --- Scene files ---
+// main.scene: a header followed by the packed object columns and the
+// defined variables, each section 8-byte aligned at the offset the header
+// records. Native byte order; the header carries the version.
+typedef struct {
+    char magic[4];                 // "2DSC"
+    unsigned int version;          // SCENE_VERSION
+    unsigned int headerSize;       // sizeof(SceneHeader) when written
+    unsigned int objectCount;
+    unsigned int variableCount;
+    unsigned int nameLength;       // NAME_LEN
+    unsigned long long positionOffset;  // Vector2[objectCount]
+    unsigned long long sizeOffset;      // float[objectCount]
+    unsigned long long colorOffset;     // Color[objectCount]
+    unsigned long long shapeOffset;     // unsigned char[objectCount]
+    unsigned long long selectedOffset;  // unsigned char[objectCount]
+    unsigned long long nameOffset;      // char[objectCount][NAME_LEN]
+    unsigned long long variableOffset;  // SceneVariable[variableCount]
+    unsigned long long journalSequence; // Matches the main.journal written after it; absent (0) in older headers
+} SceneHeader;
+
+typedef struct {
+    char name[NAME_LEN];
+    unsigned int type;             // VarType
+    unsigned char value[16];       // Raw Variable.value
+} SceneVariable;
+
+static bool WriteSection(FILE* f, unsigned long long* offset, const void* data, size_t size){
+    static const char zeros[8] = {0};
+    long pos = ftell(f);
+    if(pos < 0) return false;
+    if(pos % 8 && fwrite(zeros, 1, 8 - pos % 8, f) != (size_t)(8 - pos % 8)) return false;
+    *offset = (unsigned long long)ftell(f);
+    return size == 0 || fwrite(data, 1, size, f) == size;
+}
+
+// Flushes f and forces it to disk, so a rename after it can't expose a
+// file whose data hasn't been written yet
+static bool SyncFile(FILE* f){
+    if(fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+// Moves tmp over path. POSIX rename() replaces path atomically; on Windows
+// it won't replace an existing file, so the old one goes first there
+static bool RenameOver(const char* tmp, const char* path){
+#ifdef _WIN32
+    remove(path);
+#endif
+    return rename(tmp, path) == 0;
+}
+
+// Writes to a temporary file and renames it, so a failed save keeps the old scene
+static bool SaveScene(const char* path, unsigned long long journalSequence){
+    char tmp[300]; snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* f = fopen(tmp, "wb");
+    if(!f){ AddLog("Error: cannot write '%s'", tmp); return false; }
+    int n = objects.count;
+    SceneHeader h = { {'2','D','S','C'}, SCENE_VERSION, sizeof(SceneHeader), (unsigned int)n, 0, NAME_LEN };
+    h.journalSequence = journalSequence;
+    SceneVariable* vars = MemAlloc(MEM_IO, (variableCount ? variableCount : 1) * sizeof(SceneVariable));
+    for(int i = 0; vars && i < variableCount; i++){
+        if(!variables[i].defined) continue;
+        SceneVariable* sv = &vars[h.variableCount++];
+        memset(sv, 0, sizeof(*sv));
+        memcpy(sv->name, variables[i].name, NAME_LEN);
+        sv->type = variables[i].type;
+        memcpy(sv->value, &variables[i].value, sizeof(variables[i].value));
+    }
+    bool ok = vars && fwrite(&h, sizeof(h), 1, f) == 1 &&
+        WriteSection(f, &h.positionOffset, objects.position, n*sizeof(Vector2)) &&
+        WriteSection(f, &h.sizeOffset, objects.size, n*sizeof(float)) &&
+        WriteSection(f, &h.colorOffset, objects.color, n*sizeof(Color)) &&
+        WriteSection(f, &h.shapeOffset, objects.shape, n) &&
+        WriteSection(f, &h.selectedOffset, objects.selected, n*sizeof(bool)) &&
+        WriteSection(f, &h.nameOffset, objects.name, (size_t)n*NAME_LEN) &&
+        WriteSection(f, &h.variableOffset, vars, h.variableCount*sizeof(SceneVariable)) &&
+        fseek(f, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f) == 1 && SyncFile(f);
+    MemFree(vars);
+    if(fclose(f) != 0) ok = false;
+    if(ok) ok = RenameOver(tmp, path);
+    if(!ok){ remove(tmp); AddLog("Error: failed to save scene '%s'", path); }
+    return ok;
+}
+
+// Read-only view of a whole file: mmap where available, a heap copy on Windows
+typedef struct { const unsigned char* data; size_t size; bool mapped; } MappedFile;
+
+static bool MapFile(const char* path, MappedFile* m){
+    memset(m, 0, sizeof(*m));
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0){ close(fd); return false; }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(p == MAP_FAILED) return false;
+    m->data = p; m->size = (size_t)st.st_size; m->mapped = true;
+    return true;
+#else
+    long len = 0;
+    char* data = ReadWholeFile(path, &len, NULL);
+    if(!data) return false;
+    m->data = (const unsigned char*)data; m->size = (size_t)len;
+    return true;
+#endif
+}
+
+static void UnmapFile(MappedFile* m){
+#ifndef _WIN32
+    if(m->mapped){ munmap((void*)m->data, m->size); m->data = NULL; return; }
+#endif
+    MemFree((void*)m->data);
+    m->data = NULL;
+}
+
+static bool SceneSectionOk(const MappedFile* m, unsigned long long offset, unsigned long long size){
+    return offset <= m->size && size <= m->size - offset;
+}
+
+// Replaces the scene with the file's objects and variables, copying whole columns
+static void HashSceneNames(void* data, int chunk, int begin, int end){
+    for(int r = begin; r < end; r++){
+        objects.name[r][NAME_LEN-1] = '\0';
+        objects.nameHash[r] = HashName(objects.name[r]);
+    }
+}
+
+static bool LoadScene(const char* path, unsigned long long* journalSequence){
+    double start = NowSeconds();
+    MappedFile m;
+    if(!MapFile(path, &m)){ AddLog("Error: cannot open scene '%s'", path); return false; }
+    SceneHeader h = {0};
+    size_t minHeader = offsetof(SceneHeader, journalSequence);
+    bool ok = m.size >= minHeader;
+    if(ok){
+        memcpy(&h, m.data, minHeader);
+        if(h.headerSize >= sizeof(h) && m.size >= sizeof(h)) memcpy(&h, m.data, sizeof(h));
+    }
+    unsigned long long n = ok ? h.objectCount : 0;
+    ok = ok && memcmp(h.magic, "2DSC", 4) == 0 && h.version == SCENE_VERSION && h.nameLength == NAME_LEN &&
+         n <= MAX_OBJECTS &&
+         SceneSectionOk(&m, h.positionOffset, n*sizeof(Vector2)) && SceneSectionOk(&m, h.sizeOffset, n*sizeof(float)) &&
+         SceneSectionOk(&m, h.colorOffset, n*sizeof(Color)) && SceneSectionOk(&m, h.shapeOffset, n) &&
+         SceneSectionOk(&m, h.selectedOffset, n) && SceneSectionOk(&m, h.nameOffset, n*NAME_LEN) &&
+         SceneSectionOk(&m, h.variableOffset, (unsigned long long)h.variableCount*sizeof(SceneVariable));
+    if(!ok){ UnmapFile(&m); AddLog("Error: '%s' is not a version %d scene", path, SCENE_VERSION); return false; }
+    if(!ClearObjects() || !ObjectStoreReserve((int)n) || !NameIndexReserve((int)n)){ UnmapFile(&m); return false; }
+
+    memcpy(objects.position, m.data + h.positionOffset, n*sizeof(Vector2));
+    memcpy(objects.size, m.data + h.sizeOffset, n*sizeof(float));
+    memcpy(objects.color, m.data + h.colorOffset, n*sizeof(Color));
+    memcpy(objects.shape, m.data + h.shapeOffset, n);
+    memcpy(objects.name, m.data + h.nameOffset, n*NAME_LEN);
+    const unsigned char* selected = m.data + h.selectedOffset;
+
+    ParallelFor((int)n, 4096, HashSceneNames, NULL);
+
+    // Per-object bookkeeping; duplicate or empty names are dropped by compacting
+    int count = 0;
+    for(int r = 0; r < (int)n; r++){
+        unsigned int hash = objects.nameHash[r];
+        int bucket = NameIndexSlot(objects.name[r], hash);
+        if(!objects.name[r][0] || nameIndex[bucket] != INVALID_HANDLE) continue;
+        int i = count;
+        if(i != r){
+            objects.position[i] = objects.position[r]; objects.size[i] = objects.size[r];
+            objects.color[i] = objects.color[r]; objects.shape[i] = objects.shape[r];
+            memcpy(objects.name[i], objects.name[r], NAME_LEN);
+        }
+        ObjectHandle handle = AllocHandle(i);
+        if(handle == INVALID_HANDLE) break;
+        objects.selected[i] = selected[r] != 0;
+        if(objects.shape[i] > SHAPE_RECT) objects.shape[i] = SHAPE_CIRCLE;
+        if(!(objects.size[i] > 0)) objects.size[i] = 1;
+        objects.previous[i] = objects.position[i];
+        objects.velocity[i] = (Vector2){0, 0};
+        objects.acceleration[i] = (Vector2){0, 0};
+        objects.damping[i] = 0;
+        objects.nameHash[i] = hash;
+        objects.handle[i] = handle;
+        objects.dirty[i] = 0;
+        objects.journalPending[i] = 0;
+        objects.labelEpoch[i] = 0;
+        objects.gridCell[i] = -1;
+        nameIndex[bucket] = handle;
+        objects.count = ++count;
+        GridUpdate(i);
+    }
+    if(count != (int)n) AddLog("Warning: skipped %d objects with duplicate or empty names", (int)n - count);
+
+    for(int i = 0; i < variableCount; i++) variables[i].defined = false;
+    const SceneVariable* vars = (const SceneVariable*)(m.data + h.variableOffset);
+    for(unsigned int k = 0; k < h.variableCount; k++){
+        char name[NAME_LEN]; memcpy(name, vars[k].name, NAME_LEN); name[NAME_LEN-1] = '\0';
+        int slot = InternVariable(name);
+        if(slot < 0 || vars[k].type > VAR_COLOR) continue;
+        variables[slot].type = (VarType)vars[k].type;
+        memcpy(&variables[slot].value, vars[k].value, sizeof(variables[slot].value));
+        variables[slot].defined = true;
+    }
+    UnmapFile(&m);
+    *journalSequence = h.journalSequence;
+
+    AddLog("Loaded %d objects and %u variables in %.1f ms", objects.count, h.variableCount, (NowSeconds()-start)*1000.0);
+    return true;
+}
+
+// The original text format, kept as an export: one "shape name x y size r g b" line per object
+static bool ExportSceneText(const char* path){
+    FILE *f = fopen(path,"w");
+    if(!f){ AddLog("Error: cannot write '%s'", path); return false; }
+    fprintf(f,"# %s Project\n",currentProject);
+    for(int i=0;i<objects.count;i++){
+        fprintf(f,"%s %s %.0f %.0f %.0f %d %d %d\n",
+            objects.shape[i]==SHAPE_CIRCLE?"circle":"rect", objects.name[i], objects.position[i].x,objects.position[i].y,objects.size[i],
+            objects.color[i].r,objects.color[i].g,objects.color[i].b);
+    }
+    fclose(f);
+    return true;
+}
+
+static void SceneFilePath(const char* project, char* out, size_t size){
+    snprintf(out, size, "./Projects/%s/main.scene", project);
+}
+
+static void JournalFilePath(const char* project, char* out, size_t size){
+    snprintf(out, size, "./Projects/%s/main.journal", project);
+}
+
+// Writes the queued object and variable changes and hands them to the OS
+static void JournalFlush(void){
+    JournalRecord r;
+    for(int k = 0; k < journal.pendingCount; k++){
+        int i = ObjectIndex(journal.pending[k]);
+        if(i < 0) continue; // Deleted since; its DELETE record is already written
+        objects.journalPending[i] = 0;
+        if(!journal.file) continue;
+        JournalObjectRecord(&r, JOURNAL_UPDATE, i);
+        JournalWrite(&r);
+    }
+    journal.pendingCount = 0;
+    for(int k = 0; k < journal.pendingVariableCount; k++){
+        Variable* v = &variables[journal.pendingVariables[k]];
+        v->journalPending = false;
+        if(!journal.file) continue;
+        memset(&r, 0, sizeof(r));
+        r.op = JOURNAL_VARIABLE;
+        r.kind = v->type;
+        memcpy(r.name, v->name, NAME_LEN);
+        memcpy(r.value, &v->value, sizeof(v->value));
+        JournalWrite(&r);
+    }
+    journal.pendingVariableCount = 0;
+    if(journal.file) fflush(journal.file);
+    journal.lastFlush = NowSeconds();
+}
+
+// Flushes and fsyncs the journal: what a save costs when nothing needs compacting
+static bool JournalSync(void){
+    JournalFlush();
+    if(!journal.file) return false;
+    if(!journal.unsynced) return true;
+    bool ok = SyncFile(journal.file);
+    if(!ok){ AddLog("Error: failed to sync the project journal"); return false; }
+    journal.unsynced = false;
+    return true;
+}
+
+static void JournalClose(void){
+    if(!journal.file) return;
+    JournalSync();
+    if(journal.file) fclose(journal.file);
+    journal.file = NULL;
+}
+
+// Starts appending to the project's journal; a fresh one replaces any old file
+static bool JournalOpen(const char* project, unsigned long long sequence, bool fresh, long records){
+    char path[256]; JournalFilePath(project, path, sizeof(path));
+    if(fresh){
+        char tmp[300]; snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+        JournalHeader h = { {'2','D','J','R'}, JOURNAL_VERSION, sequence };
+        FILE* f = fopen(tmp, "wb");
+        bool ok = f && fwrite(&h, sizeof(h), 1, f) == 1 && SyncFile(f);
+        if(f && fclose(f) != 0) ok = false;
+        if(ok) ok = RenameOver(tmp, path);
+        if(!ok){ remove(tmp); AddLog("Error: cannot create journal '%s'", path); return false; }
+        records = 0;
+    }
+    journal.file = fopen(path, "ab");
+    if(!journal.file){ AddLog("Error: cannot open journal '%s'", path); return false; }
+    journal.sequence = sequence;
+    journal.records = records;
+    journal.unsynced = false;
+    journal.lastFlush = NowSeconds();
+    return true;
+}
+
+// Sequence in an existing journal's header, 0 if there is none
+static unsigned long long JournalFileSequence(const char* project){
+    char path[256]; JournalFilePath(project, path, sizeof(path));
+    JournalHeader h;
+    FILE* f = fopen(path, "rb");
+    if(!f) return 0;
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 && memcmp(h.magic, "2DJR", 4) == 0;
+    fclose(f);
+    return ok ? h.sequence : 0;
+}
+
+// Applies main.journal on top of the snapshot just loaded. Returns false when
+// there is nothing to apply (no journal, or one the snapshot already contains);
+// *torn is set when replay stopped at a partial or damaged record.
+static bool JournalReplay(const char* project, unsigned long long sequence, long* records, bool* torn){
+    char path[256]; JournalFilePath(project, path, sizeof(path));
+    *records = 0; *torn = false;
+    MappedFile m;
+    if(!MapFile(path, &m)) return false;
+    JournalHeader h;
+    if(m.size < sizeof(h)){ UnmapFile(&m); return false; }
+    memcpy(&h, m.data, sizeof(h));
+    if(memcmp(h.magic, "2DJR", 4) != 0 || h.version != JOURNAL_VERSION || h.sequence != sequence){
+        UnmapFile(&m);
+        AddLog("Warning: ignoring journal '%s' that does not match the saved scene", path);
+        return false;
+    }
+    double start = NowSeconds();
+    size_t pos = sizeof(h);
+    JournalRecord r;
+    for(; pos + sizeof(r) <= m.size; pos += sizeof(r)){
+        memcpy(&r, m.data + pos, sizeof(r));
+        if(r.checksum != HashBytes((const unsigned char*)&r + sizeof(r.checksum), sizeof(r) - sizeof(r.checksum))) break;
+        char name[NAME_LEN]; memcpy(name, r.name, NAME_LEN); name[NAME_LEN-1] = '\0';
+        switch(r.op){
+            case JOURNAL_ADD:
+                InsertObject(name, r.kind == SHAPE_RECT ? SHAPE_RECT : SHAPE_CIRCLE, r.position, r.size, r.color);
+                break;
+            case JOURNAL_DELETE: {
+                int i = FindByName(name);
+                if(i >= 0) RemoveObject(i);
+                break;
+            }
+            case JOURNAL_UPDATE: {
+                int i = FindByName(name);
+                if(i < 0) break;
+                objects.size[i] = r.size > 0 ? r.size : 1;
+                objects.color[i] = r.color;
+                SetObjectPosition(i, r.position);
+                break;
+            }
+            case JOURNAL_VARIABLE: {
+                int slot = InternVariable(name);
+                if(slot < 0 || r.kind > VAR_COLOR) break;
+                variables[slot].type = r.kind;
+                memcpy(&variables[slot].value, r.value, sizeof(variables[slot].value));
+                variables[slot].defined = true;
+                break;
+            }
+        }
+        (*records)++;
+    }
+    *torn = pos != m.size;
+    UnmapFile(&m);
+    if(*torn) AddLog("Warning: journal '%s' ends in a damaged record; changes after it are lost", path);
+    if(*records) AddLog("Replayed %ld journal changes in %.1f ms", *records, (NowSeconds()-start)*1000.0);
+    return true;
+}
+
+// Folds the journal into a new main.scene and starts an empty journal after it.
+// If the snapshot cannot be written the current journal stays in use.
+static bool CompactProject(const char* project){
+    JournalSync();
+    unsigned long long sequence = JournalFileSequence(project) + 1;
+    if(journal.file && journal.sequence >= sequence) sequence = journal.sequence + 1;
+    char sceneFile[256]; SceneFilePath(project, sceneFile, sizeof(sceneFile));
+    if(!SaveScene(sceneFile, sequence)) return false;
+    objects.motionUnsaved = false;
+    if(journal.file){ fclose(journal.file); journal.file = NULL; }
+    return JournalOpen(project, sequence, true, 0);
+}
+
+static bool JournalNeedsCompaction(void){
+    return journal.records > JOURNAL_COMPACT_MIN && journal.records > objects.count;
+}
+
+// Called between frames/ticks: writes queued changes once per JOURNAL_FLUSH_INTERVAL
+static void JournalPoll(void){
+    if(!journal.file || NowSeconds() - journal.lastFlush < JOURNAL_FLUSH_INTERVAL) return;
+    JournalFlush();
+    if(JournalNeedsCompaction()) CompactProject(currentProject);
+}
+
+// Loads main.scene and its journal; false when the project has no saved scene
+static bool LoadProjectScene(const char* project){
+    char sceneFile[256]; SceneFilePath(project, sceneFile, sizeof(sceneFile));
+    struct stat st;
+    unsigned long long sequence = 0;
+    if(stat(sceneFile, &st) != 0 || !LoadScene(sceneFile, &sequence)) return false;
+    long records; bool torn;
+    bool replayed = JournalReplay(project, sequence, &records, &torn);
+    if(replayed && torn) CompactProject(project);
+    else JournalOpen(project, sequence, !replayed, records);
+    return true;
+}
+
+// Saves the scene. For the open project that is an fsync of the journal,
+// with a full snapshot only once the journal outgrows the scene; saving
+// under another name writes a snapshot there and switches to it.
+static void UpdateProject(const char* name){
+    bool sameProject = journal.file && strcmp(name, currentProject) == 0;
+    if(!sameProject) JournalClose();
+    strncpy(currentProject, name, NAME_LEN-1);
+    currentProject[NAME_LEN-1] = '\0'; // safe terminate
+    char path[256]; snprintf(path,sizeof(path),"./Projects/%s",name);
+    CreateDirIfNotExist("./Projects"); CreateDirIfNotExist(path);
+    SetLogProject(name);
+    char scriptsDir[256]; snprintf(scriptsDir,sizeof(scriptsDir),"%s/scripts",path);
+    CreateDirIfNotExist(scriptsDir);
+    if(sameProject && !JournalNeedsCompaction() && !objects.motionUnsaved){
+        if(JournalSync()) AddLog("Project '%s' updated (%ld changes since the last snapshot)", name, journal.records);
+    }
+    else if(CompactProject(name)) AddLog("Project '%s' updated", name);
+}
+
+static void LoadScripts(const char* projectName);
+
+// Switches to an existing project: its scene (if saved) and scripts
+static void OpenProject(const char* name){
+    char path[256]; snprintf(path,sizeof(path),"./Projects/%s",name);
+    char sceneFile[256]; SceneFilePath(name, sceneFile, sizeof(sceneFile));
+    struct stat st;
+    if(stat(path, &st) != 0){ AddLog("Error: project '%s' not found", name); return; }
+    bool hasScene = stat(sceneFile, &st) == 0;
+    if(objects.viewExports > 0){ AddLog("Error: object store is locked by %d Python view(s)", objects.viewExports); return; }
+    // Queued changes belong to the project being left
+    bool wasJournaling = journal.file != NULL;
+    unsigned long long sequence = journal.sequence; long records = journal.records;
+    JournalClose();
+    if(hasScene ? !LoadProjectScene(name) : !ClearObjects()){
+        if(wasJournaling) JournalOpen(currentProject, sequence, false, records);
+        return;
+    }
+    strncpy(currentProject, name, NAME_LEN-1);
+    currentProject[NAME_LEN-1] = '\0';
+    SetLogProject(name);
+    ObjectStoreTrim();
+    LoadScripts(name);
+    AddLog("Opened project '%s'", name);
+}
+
+static Script* FindScript(const char* name){
+    for(int i = 0; i < scriptCount; i++) if(strcmp(scripts[i].name, name) == 0) return &scripts[i];
+    return NULL;
+}
+
+// Appends an empty script; the pointer is valid until the next add or remove
+static Script* AddScript(const char* name){
+    if(scriptCount == scriptCapacity){
+        int cap = scriptCapacity ? scriptCapacity*2 : 64;
+        if(!GrowArray((void**)&scripts, cap, sizeof(Script), MEM_SCRIPTS)) return NULL;
+        scriptCapacity = cap;
+    }
+    Script* s = &scripts[scriptCount++];
+    memset(s, 0, sizeof(*s));
+    strncpy(s->name, name, NAME_LEN-1);
+    s->isScript = (strstr(name, ".script") != NULL);
+    s->isPython = (strstr(name, ".py") != NULL);
+    return s;
+}
+
+static void RemoveScript(Script* s){
+    TextBufferRelease(s->text);
+    FreeProgram(&s->program);
+    int i = (int)(s - scripts);
+    memmove(&scripts[i], &scripts[i+1], (size_t)(scriptCount - i - 1) * sizeof(Script));
+    scriptCount--;
+}
+
+static void SaveScript(ScriptEditor* ed){
+    char scriptsDir[256];
+    snprintf(scriptsDir, sizeof(scriptsDir), "./Projects/%s/scripts", currentProject);
+    CreateDirIfNotExist("./Projects");
+    CreateDirIfNotExist(scriptsDir);
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", scriptsDir, ed->name);
+
+    FILE *f = fopen(path,"w");
+    if(!f){ 
+        AddLog("Failed to save '%s'", ed->name); 
+        return; 
+    }
+    for(int i=0;i<TextLineCount(ed->text);i++) {
+        fprintf(f,"%s\n", TextLineStr(ed->text, i));
+    }
+    fclose(f);
+
+    ed->modified = false;
+
+    // The loaded script shares the editor's buffer; recompile it
+    Script *s = FindScript(ed->name);
+    if(!s && (s = AddScript(ed->name))){
+        s->isScript = ed->isScript;
+        s->isPython = ed->isPython;
+    }
+    if(s){
+        if(s->text != ed->text){ TextBufferRelease(s->text); s->text = TextBufferRetain(ed->text); }
+        CompileScript(s);
+    }
+    if(ed->isPython) InvalidatePythonCode(currentProject, ed->name);
+    AddLog("Saved '%s' in project '%s'", ed->name, currentProject);
+}
+
+// --- Script compiler ---
+static void FreeProgram(ScriptProgram* p){
+    MemFree(p->code); MemFree(p->args); MemFree(p->nodes); MemFree(p->strings);
+    memset(p, 0, sizeof(*p));
+}
+
+static int ProgramString(ScriptProgram* p, const char* text){
+    int len = (int)strlen(text) + 1;
+    if(p->stringsLen + len > p->stringsCap){
+        int cap = p->stringsCap ? p->stringsCap : 256;
+        while(p->stringsLen + len > cap) cap *= 2;
+        if(!GrowArray((void**)&p->strings, cap, 1, MEM_PROGRAMS)) return -1;
+        p->stringsCap = cap;
+    }
+    memcpy(p->strings + p->stringsLen, text, len);
+    p->stringsLen += len;
+    return p->stringsLen - len;
+}
+
+// --- Expression compiler ---
+// Recursive descent over the text with the usual precedence:
+//   expr  := term (('+'|'-') term)*
+//   term  := unary (('*'|'/') unary)*
+//   unary := ('-'|'+') unary | primary
+//   primary := number | name | name '(' args ')' | '(' expr ')'
+// Collision functions take object names (or #handles) instead of expressions.
+// Trig functions work in degrees. Constant subexpressions are folded as
+// they are emitted, so "speed*2*(1+1)" costs one load and one multiply.
+typedef struct {
+    ScriptProgram* p;
+    const char* src;
+    int pos;
+    int depth, maxDepth;
+    bool failed;
+} ExprParser;
+
+static double simTime = 0.0; // Seconds of simulation, advanced by SimulationTick
+
+static void ExprSkipSpaces(ExprParser* ps){ while(ps->src[ps->pos] == ' ' || ps->src[ps->pos] == '\t') ps->pos++; }
+
+static ExprNode* ExprEmit(ExprParser* ps, ExprOp op, float value, int slot, int stackDelta){
+    ScriptProgram* p = ps->p;
+    if(p->nodeCount == p->nodeCapacity){
+        int cap = p->nodeCapacity ? p->nodeCapacity*2 : 64;
+        if(!GrowArray((void**)&p->nodes, cap, sizeof(ExprNode), MEM_PROGRAMS)){ ps->failed = true; return NULL; }
+        p->nodeCapacity = cap;
+    }
+    ps->depth += stackDelta;
+    if(ps->depth > ps->maxDepth) ps->maxDepth = ps->depth;
+    ExprNode* n = &p->nodes[p->nodeCount++];
+    n->op = (unsigned char)op; n->value = value; n->slot = slot; n->component = 0;
+    return n;
+}
+
+static float ApplyExprOp(ExprOp op, float a, float b){
+    switch(op){
+        case EX_ADD: return a + b;
+        case EX_SUB: return a - b;
+        case EX_MUL: return a * b;
+        case EX_DIV: return b != 0 ? a / b : 0;
+        case EX_NEG: return -a;
+        case EX_SIN: return sinf(a * PI / 180.0f);
+        case EX_COS: return cosf(a * PI / 180.0f);
+        case EX_SQRT: return a >= 0 ? sqrtf(a) : 0;
+        case EX_ABS: return fabsf(a);
+        case EX_MIN: return a < b ? a : b;
+        case EX_MAX: return a > b ? a : b;
+        case EX_ATAN2: return atan2f(a, b) * 180.0f / PI;
+        default: return 0;
+    }
+}
+
+// Emits an operator, folding it when all of its operands are constants
+static void ExprEmitOp(ExprParser* ps, ExprOp op, int arity){
+    ScriptProgram* p = ps->p;
+    if(ps->failed) return;
+    bool constant = p->nodeCount >= arity;
+    for(int i = 1; i <= arity && constant; i++) constant = p->nodes[p->nodeCount-i].op == EX_CONST;
+    if(constant){
+        float a = p->nodes[p->nodeCount-arity].value;
+        float b = arity > 1 ? p->nodes[p->nodeCount-1].value : 0;
+        p->nodeCount -= arity;
+        ps->depth -= arity;
+        ExprEmit(ps, EX_CONST, ApplyExprOp(op, a, b), -1, 1);
+        return;
+    }
+    ExprEmit(ps, op, 0, -1, 1 - arity);
+}
+
+static void ParseExprSum(ExprParser* ps);
+
+static void ParseExprObject(ExprParser* ps){
+    ExprSkipSpaces(ps);
+    const char* c = ps->src + ps->pos;
+    char name[NAME_LEN];
+    int n = 0;
+    while(c[n] && c[n] != ',' && c[n] != ')' && c[n] != ' ' && c[n] != '\t'){ if(n < NAME_LEN-1) name[n] = c[n]; n++; }
+    name[n < NAME_LEN-1 ? n : NAME_LEN-1] = '\0';
+    ps->pos += n;
+    int offset = n > 0 ? ProgramString(ps->p, name) : -1;
+    if(offset < 0){ ps->failed = true; return; }
+    ExprEmit(ps, EX_OBJECT, 0, offset, 1);
+}
+
+static void ParseExprPrimary(ExprParser* ps){
+    ExprSkipSpaces(ps);
+    const char* c = ps->src + ps->pos;
+    if(isdigit((unsigned char)*c) || (*c == '.' && isdigit((unsigned char)c[1]))){
+        char* end;
+        float value = strtof(c, &end);
+        ps->pos += (int)(end - c);
+        ExprEmit(ps, EX_CONST, value, -1, 1);
+        return;
+    }
+    if(*c == '('){
+        ps->pos++;
+        ParseExprSum(ps);
+        ExprSkipSpaces(ps);
+        if(ps->src[ps->pos] != ')'){ ps->failed = true; return; }
+        ps->pos++;
+        return;
+    }
+    if(isalpha((unsigned char)*c) || *c == '_'){
+        char ident[NAME_LEN];
+        int n = 0;
+        while(isalnum((unsigned char)c[n]) || c[n] == '_' || c[n] == '.'){ if(n < NAME_LEN-1) ident[n] = c[n]; n++; }
+        ident[n < NAME_LEN-1 ? n : NAME_LEN-1] = '\0';
+        ps->pos += n;
+        ExprSkipSpaces(ps);
+        if(ps->src[ps->pos] != '('){
+            char base[NAME_LEN];
+            int component = ParseVariableRef(ident, base);
+            int slot = InternVariable(base);
+            ExprNode* node = ExprEmit(ps, slot >= 0 ? EX_VAR : EX_CONST, 0, slot, 1);
+            if(node) node->component = (unsigned char)component;
+            return;
+        }
+        static const struct { const char* name; ExprOp op; int arity; bool objects; } funcs[] = {
+            {"sin", EX_SIN, 1}, {"cos", EX_COS, 1}, {"sqrt", EX_SQRT, 1}, {"abs", EX_ABS, 1},
+            {"min", EX_MIN, 2}, {"max", EX_MAX, 2}, {"atan2", EX_ATAN2, 2}, {"time", EX_TIME, 0},
+            {"touching", EX_TOUCHING, 2, true}, {"collided", EX_COLLIDED, 2, true},
+            {"contacts", EX_CONTACTS, 1, true}, {"collisions", EX_COLLISIONS, 0}
+        };
+        int f = -1;
+        for(int i = 0; i < (int)(sizeof(funcs)/sizeof(funcs[0])); i++) if(strcmp(ident, funcs[i].name) == 0) f = i;
+        if(f < 0){ ps->failed = true; return; }
+        ps->pos++; // '('
+        for(int a = 0; a < funcs[f].arity; a++){
+            if(a > 0){
+                ExprSkipSpaces(ps);
+                if(ps->src[ps->pos] != ','){ ps->failed = true; return; }
+                ps->pos++;
+            }
+            if(funcs[f].objects) ParseExprObject(ps); else ParseExprSum(ps);
+        }
+        ExprSkipSpaces(ps);
+        if(ps->src[ps->pos] != ')'){ ps->failed = true; return; }
+        ps->pos++;
+        if(funcs[f].arity == 0) ExprEmit(ps, funcs[f].op, 0, -1, 1);
+        else ExprEmitOp(ps, funcs[f].op, funcs[f].arity);
+        return;
+    }
+    ps->failed = true;
+}
+
+static void ParseExprUnary(ExprParser* ps){
+    ExprSkipSpaces(ps);
+    char c = ps->src[ps->pos];
+    if(c == '-' || c == '+'){
+        ps->pos++;
+        ParseExprUnary(ps);
+        if(c == '-') ExprEmitOp(ps, EX_NEG, 1);
+        return;
+    }
+    ParseExprPrimary(ps);
+}
+
+static void ParseExprProduct(ExprParser* ps){
+    ParseExprUnary(ps);
+    for(;;){
+        ExprSkipSpaces(ps);
+        char c = ps->src[ps->pos];
+        if(ps->failed || (c != '*' && c != '/')) return;
+        ps->pos++;
+        ParseExprUnary(ps);
+        ExprEmitOp(ps, c == '*' ? EX_MUL : EX_DIV, 2);
+    }
+}
+
+static void ParseExprSum(ExprParser* ps){
+    ParseExprProduct(ps);
+    for(;;){
+        ExprSkipSpaces(ps);
+        char c = ps->src[ps->pos];
+        if(ps->failed || (c != '+' && c != '-')) return;
+        ps->pos++;
+        ParseExprProduct(ps);
+        ExprEmitOp(ps, c == '+' ? EX_ADD : EX_SUB, 2);
+    }
+}
+
+// Compiles expr into p's node pool; on a syntax error the operand becomes 0
+static ScriptArg CompileExpression(ScriptProgram* p, const char* expr){
+    ExprParser ps = { p, expr, 0, 0, 0, false };
+    ScriptArg a = { p->nodeCount, 0 };
+    ParseExprSum(&ps);
+    ExprSkipSpaces(&ps);
+    if(ps.src[ps.pos] != '\0' || ps.maxDepth > EXPR_STACK) ps.failed = true;
+    if(ps.failed){
+        AddLog("Error: bad expression '%s'", expr);
+        p->nodeCount = a.first;
+        ExprEmit(&ps, EX_CONST, 0, -1, 1);
+    }
+    a.count = p->nodeCount - a.first;
+    return a;
+}
+
+static float EvalExpr(const ScriptProgram* p, ScriptArg a){
+    ExprNode* n = &p->nodes[a.first];
+    if(a.count == 1 && n->op == EX_CONST) return n->value;
+    float stack[EXPR_STACK];
+    int sp = 0;
+    for(int i = 0; i < a.count; i++, n++){
+        switch(n->op){
+            case EX_CONST: stack[sp++] = n->value; break;
+            case EX_VAR: stack[sp++] = VariableValue(n->slot, n->component); break;
+            case EX_TIME: stack[sp++] = (float)simTime; break;
+            case EX_OBJECT: stack[sp++] = (float)ResolveObject(p->strings + n->slot); break;
+            case EX_COLLISIONS: EnableCollisions(); stack[sp++] = (float)collision.pairCount; break;
+            case EX_CONTACTS: stack[sp-1] = (float)CollisionContacts((int)stack[sp-1]); break;
+            case EX_TOUCHING: case EX_COLLIDED:
+                sp--;
+                stack[sp-1] = (n->op == EX_TOUCHING ? CollisionTouching((int)stack[sp-1], (int)stack[sp])
+                                                    : CollisionBegan((int)stack[sp-1], (int)stack[sp])) ? 1.0f : 0.0f;
+                break;
+            case EX_NEG: case EX_SIN: case EX_COS: case EX_SQRT: case EX_ABS:
+                stack[sp-1] = ApplyExprOp((ExprOp)n->op, stack[sp-1], 0);
+                break;
+            default:
+                sp--;
+                stack[sp-1] = ApplyExprOp((ExprOp)n->op, stack[sp-1], stack[sp]);
+                break;
+        }
+    }
+    return stack[0];
+}
+
+// One-off evaluation of expression text (console commands)
+static float EvaluateExpression(const char* expr){
+    ScriptProgram tmp = {0};
+    float value = EvalExpr(&tmp, CompileExpression(&tmp, expr));
+    FreeProgram(&tmp);
+    return value;
+}
+
+// Appends one compiled operand to the instruction emitted last
+static void EmitArg(ScriptProgram* p, Instruction* in, const char* text){
+    if(p->argCount == p->argCapacity){
+        int cap = p->argCapacity ? p->argCapacity*2 : 32;
+        if(!GrowArray((void**)&p->args, cap, sizeof(ScriptArg), MEM_PROGRAMS)) return;
+        p->argCapacity = cap;
+    }
+    p->args[p->argCount++] = CompileExpression(p, text);
+    in->argCount++;
+}
+
+static Instruction* EmitOp(ScriptProgram* p, OpCode op, const char* name, const char (*argText)[64], int argCount){
+    if(p->count == p->capacity){
+        int cap = p->capacity ? p->capacity*2 : 16;
+        if(!GrowArray((void**)&p->code, cap, sizeof(Instruction), MEM_PROGRAMS)) return NULL;
+        p->capacity = cap;
+    }
+    Instruction* in = &p->code[p->count++];
+    in->op = (unsigned char)op;
+    in->argCount = 0;
+    in->firstArg = p->argCount;
+    in->name = name ? ProgramString(p, name) : -1;
+    in->object = INVALID_HANDLE;
+    in->slot = -1;
+    in->component = 0;
+    for(int i = 0; i < argCount; i++) EmitArg(p, in, argText[i]);
+    return in;
+}
+
+// Parses one line with the same grammar the interpreter always accepted
+static void CompileLine(ScriptProgram* p, const char* line) {
+    if(strlen(line) == 0 || line[0] == '#') return;
+    
+    char cmd[CMD_LEN];
+    strncpy(cmd, line, CMD_LEN-1);
+    cmd[CMD_LEN-1] = '\0';
+    
+    char word[64];
+    if(sscanf(cmd, "%63s", word) != 1) return;
+    
+    char objName[NAME_LEN];
+    char args[6][64];
+
+    // Variable assignment: var = expression
+    char* equals = strchr(cmd, '=');
+    if(equals) {
+        *equals = '\0';
+        char varName[64], base[NAME_LEN];
+        sscanf(cmd, "%63s", varName);
+        Instruction* in = EmitOp(p, OP_ASSIGN, varName, NULL, 0);
+        if(in) {
+            in->component = (unsigned char)ParseVariableRef(varName, base);
+            in->slot = InternVariable(base);
+            EmitArg(p, in, equals + 1);
+        }
+        return;
+    }
+    
+    // Move object: move objectName deltaX deltaY
+    if(strcmp(word, "move") == 0) {
+        if(sscanf(cmd, "move %31s %63s %63s", objName, args[0], args[1]) == 3)
+            EmitOp(p, OP_MOVE, objName, args, 2);
+        return;
+    }
+    
+    // Set position: setPos objectName x y
+    if(strcmp(word, "setPos") == 0) {
+        if(sscanf(cmd, "setPos %31s %63s %63s", objName, args[0], args[1]) == 3)
+            EmitOp(p, OP_SET_POS, objName, args, 2);
+        return;
+    }
+    
+    // Set color: setColor objectName r g b
+    if(strcmp(word, "setColor") == 0) {
+        if(sscanf(cmd, "setColor %31s %63s %63s %63s", objName, args[0], args[1], args[2]) == 4)
+            EmitOp(p, OP_SET_COLOR, objName, args, 3);
+        return;
+    }
+    
+    // Create circle: createCircle name x y size r g b
+    if(strcmp(word, "createCircle") == 0) {
+        if(sscanf(cmd, "createCircle %31s %63s %63s %63s %63s %63s %63s", 
+                 objName, args[0], args[1], args[2], args[3], args[4], args[5]) == 7)
+            EmitOp(p, OP_CREATE_CIRCLE, objName, args, 6);
+        return;
+    }
+    
+    // Create rectangle: createRect name x y size r g b
+    if(strcmp(word, "createRect") == 0) {
+        if(sscanf(cmd, "createRect %31s %63s %63s %63s %63s %63s %63s", 
+                 objName, args[0], args[1], args[2], args[3], args[4], args[5]) == 7)
+            EmitOp(p, OP_CREATE_RECT, objName, args, 6);
+        return;
+    }
+    
+    // Motion: setVel / setAccel objectName x y, setDamping objectName d
+    if(strcmp(word, "setVel") == 0 || strcmp(word, "setAccel") == 0) {
+        if(sscanf(cmd, "%*s %31s %63s %63s", objName, args[0], args[1]) == 3)
+            EmitOp(p, word[3] == 'V' ? OP_SET_VELOCITY : OP_SET_ACCEL, objName, args, 2);
+        return;
+    }
+    if(strcmp(word, "setDamping") == 0) {
+        if(sscanf(cmd, "setDamping %31s %63s", objName, args[0]) == 2)
+            EmitOp(p, OP_SET_DAMPING, objName, args, 1);
+        return;
+    }
+
+    // Log message: log "message"
+    if(strcmp(word, "log") == 0) {
+        char* quote1 = strchr(cmd, '"');
+        if(quote1) {
+            quote1++; // Skip opening quote
+            char* quote2 = strchr(quote1, '"');
+            if(quote2) {
+                *quote2 = '\0';
+                EmitOp(p, OP_LOG, quote1, NULL, 0);
+            }
+        }
+        return;
+    }
+    
+    // For loop: for var start end
+    if(strcmp(word, "for") == 0) {
+        // This would need more complex parsing for full implementation
+        EmitOp(p, OP_FOR, NULL, NULL, 0);
+        return;
+    }
+}
+
+static void CompileScript(Script* script){
+    FreeProgram(&script->program);
+    if(script->isPython) return; // Run by the interpreter, never line by line
+    for(int i = 0; i < TextLineCount(script->text); i++) CompileLine(&script->program, TextLineStr(script->text, i));
+}
+
+// --- Script VM ---
+static float EvalArg(const ScriptProgram* p, const ScriptArg* a){
+    return EvalExpr(p, *a);
+}
+
+// Dense index of the instruction's object, refreshing the cached handle if needed
+static int InstructionObject(const ScriptProgram* p, Instruction* in){
+    int i = ObjectIndex(in->object);
+    if(i < 0){
+        i = ResolveObject(p->strings + in->name);
+        in->object = i >= 0 ? objects.handle[i] : INVALID_HANDLE;
+    }
+    return i;
+}
+
+// traceAssigns logs each assignment; only one-off runs want that, since
+// per-tick runs would format a log line for every assignment every tick
+static void RunProgram(ScriptProgram* p, bool traceAssigns){
+    for(int pc = 0; pc < p->count; pc++){
+        Instruction* in = &p->code[pc];
+        ScriptArg* a = &p->args[in->firstArg];
+        switch(in->op){
+            case OP_ASSIGN: {
+                float value = EvalArg(p, &a[0]);
+                if(in->slot >= 0) SetVariableValue(in->slot, in->component, value);
+                if(traceAssigns) LogMessage(LOG_INFO, LOG_SCRIPT, "[Script] %s = %.2f", p->strings + in->name, value);
+                break;
+            }
+            case OP_MOVE: {
+                int obj = InstructionObject(p, in);
+                if(obj >= 0) {
+                    float dx = EvalArg(p, &a[0]);
+                    float dy = EvalArg(p, &a[1]);
+                    SetObjectPosition(obj, Vector2Add(objects.position[obj], (Vector2){dx, dy}));
+                }
+                break;
+            }
+            case OP_SET_POS: {
+                int obj = InstructionObject(p, in);
+                if(obj >= 0) {
+                    float x = EvalArg(p, &a[0]);
+                    float y = EvalArg(p, &a[1]);
+                    SetObjectPosition(obj, (Vector2){x, y});
+                }
+                break;
+            }
+            case OP_SET_COLOR: {
+                int obj = InstructionObject(p, in);
+                if(obj >= 0) {
+                    int r = (int)EvalArg(p, &a[0]);
+                    int g = (int)EvalArg(p, &a[1]);
+                    int b = (int)EvalArg(p, &a[2]);
+                    SetObjectColor(obj, (Color){r, g, b, 255});
+                }
+                break;
+            }
+            case OP_CREATE_CIRCLE:
+            case OP_CREATE_RECT: {
+                float x = EvalArg(p, &a[0]);
+                float y = EvalArg(p, &a[1]);
+                float size = EvalArg(p, &a[2]);
+                int r = (int)EvalArg(p, &a[3]);
+                int g = (int)EvalArg(p, &a[4]);
+                int b = (int)EvalArg(p, &a[5]);
+                in->object = AddObject(p->strings + in->name, in->op == OP_CREATE_CIRCLE ? SHAPE_CIRCLE : SHAPE_RECT,
+                                       (Vector2){x, y}, size, (Color){r, g, b, 255});
+                break;
+            }
+            case OP_SET_VELOCITY:
+            case OP_SET_ACCEL: {
+                int obj = InstructionObject(p, in);
+                if(obj >= 0) {
+                    Vector2 v = { EvalArg(p, &a[0]), EvalArg(p, &a[1]) };
+                    if(in->op == OP_SET_VELOCITY) SetObjectVelocity(obj, v); else SetObjectAcceleration(obj, v);
+                }
+                break;
+            }
+            case OP_SET_DAMPING: {
+                int obj = InstructionObject(p, in);
+                if(obj >= 0) SetObjectDamping(obj, EvalArg(p, &a[0]));
+                break;
+            }
+            case OP_LOG:
+                LogMessage(LOG_INFO, LOG_SCRIPT, "[Script] %s", p->strings + in->name);
+                break;
+            case OP_FOR:
+                LogMessage(LOG_INFO, LOG_SCRIPT, "[Script] For loop detected");
+                break;
+        }
+    }
+}
+
+static void ExecuteScript(const char* scriptName) {
+    PROFILE_SCOPE(PZ_EXEC_SCRIPT);
+    // Find the script
+    Script *script = NULL;
+    for(int i = 0; i < scriptCount; i++) {
+        if(strcmp(scripts[i].name, scriptName) == 0) {
+            script = &scripts[i];
+            break;
+        }
+    }
+    
+    if(!script) {
+        AddLog("Script '%s' not found", scriptName);
+        return;
+    }
+    
+    RunProgram(&script->program, true);
+    
+    AddLog("Executed script '%s'", scriptName);
+}
+
+// Execute and clear whatever the Python API queued in game_commands
+static int DispatchPythonCommands(void) {
+    if(!Py_IsInitialized()) return 0;
+    PyGILState_STATE gil = PyGILState_Ensure();
+    int executed = 0;
+    PyObject* commandsList = PyObject_GetAttrString(PyImport_AddModule("__main__"), "game_commands");
+    if(commandsList && PyList_Check(commandsList)) {
+        Py_ssize_t size = PyList_Size(commandsList);
+        for(Py_ssize_t i = 0; i < size; i++) {
+            PyObject* item = PyList_GetItem(commandsList, i);
+            if(PyUnicode_Check(item)) {
+                const char* cmd = PyUnicode_AsUTF8(item);
+                if(cmd) {
+                    ExecuteCommand(cmd);
+                    executed++;
+                }
+            }
+        }
+        // Drop what we ran so the next dispatch doesn't replay it
+        if(size > 0) PyList_SetSlice(commandsList, 0, size, NULL);
+    }
+    Py_XDECREF(commandsList);
+    if(PyErr_Occurred()) PyErr_Clear();
+    PyGILState_Release(gil);
+    return executed;
+}
+
+// --- Python hooks ---
+// Each .py file keeps its own globals between runs. on_start()/on_update(dt)
+// found there are cached and called by SimulationTick while running, and
+// on_collision(a, b) once for every pair that began overlapping last tick.
+typedef struct {
+    char project[NAME_LEN];
+    char name[NAME_LEN];
+    PyObject* globals;
+    PyObject* onStart;
+    PyObject* onUpdate;
+    PyObject* onCollision;
+    bool started;
+} PythonHooks;
+
+static PythonHooks* pyHooks = NULL;
+static int pyHookCount = 0, pyHookCapacity = 0;
+
+static PythonHooks* FindPythonHooks(const char* project, const char* name){
+    for(int i = 0; i < pyHookCount; i++)
+        if(strcmp(pyHooks[i].name, name) == 0 && strcmp(pyHooks[i].project, project) == 0) return &pyHooks[i];
+    return NULL;
+}
+
+// Namespace a script executes in: created from __main__ on first use
+static PyObject* PythonScriptGlobals(const char* project, const char* name){
+    PythonHooks* h = FindPythonHooks(project, name);
+    if(h) return h->globals;
+    if(pyHookCount == pyHookCapacity){
+        int cap = pyHookCapacity ? pyHookCapacity*2 : 8;
+        if(!GrowArray((void**)&pyHooks, cap, sizeof(PythonHooks), MEM_PYTHON)) return NULL;
+        pyHookCapacity = cap;
+    }
+    PyObject* globals = PyDict_Copy(PyModule_GetDict(PyImport_AddModule("__main__")));
+    if(!globals) return NULL;
+    h = &pyHooks[pyHookCount++];
+    memset(h, 0, sizeof(*h));
+    strncpy(h->project, project, NAME_LEN-1);
+    strncpy(h->name, name, NAME_LEN-1);
+    h->globals = globals;
+    return globals;
+}
+
+static PyObject* PythonHook(PyObject* globals, const char* name){
+    PyObject* fn = PyDict_GetItemString(globals, name); // Borrowed
+    return fn && PyCallable_Check(fn) ? Py_NewRef(fn) : NULL;
+}
+
+// Picks up the hooks a script just (re)defined; on_start runs again on the next tick
+static void RegisterPythonHooks(const char* project, const char* name){
+    PythonHooks* h = FindPythonHooks(project, name);
+    if(!h) return;
+    Py_XSETREF(h->onStart, PythonHook(h->globals, "on_start"));
+    Py_XSETREF(h->onUpdate, PythonHook(h->globals, "on_update"));
+    Py_XSETREF(h->onCollision, PythonHook(h->globals, "on_collision"));
+    h->started = false;
+    if(h->onCollision) EnableCollisions();
+    if(h->onStart || h->onUpdate || h->onCollision) AddLog("Registered Python hooks from '%s'", name);
+}
+
+static void RemovePythonHooks(const char* project, const char* name){
+    PythonHooks* h = FindPythonHooks(project, name);
+    if(!h) return;
+    PyGILState_STATE gil = PyGILState_Ensure();
+    Py_CLEAR(h->onStart);
+    Py_CLEAR(h->onUpdate);
+    Py_CLEAR(h->onCollision);
+    Py_CLEAR(h->globals);
+    PyGILState_Release(gil);
+    *h = pyHooks[--pyHookCount];
+}
+
+static void ClearPythonHooks(void){
+    for(int i = 0; i < pyHookCount; i++){
+        Py_CLEAR(pyHooks[i].onStart);
+        Py_CLEAR(pyHooks[i].onUpdate);
+        Py_CLEAR(pyHooks[i].onCollision);
+        Py_CLEAR(pyHooks[i].globals);
+    }
+    pyHookCount = 0;
+}
+
+// A hook that raises is dropped so the error isn't repeated every frame
+static void PythonHookFailed(PythonHooks* h, PyObject** hook, const char* what){
+    PyErr_Print();
+    AddLog("Error: %s in '%s' failed, hook removed", what, h->name);
+    Py_CLEAR(*hook);
+}
+
+// Calls every hook of the current project once; one GIL acquisition per tick
+static void RunPythonHooks(double dt){
+    if(pyHookCount == 0 || !Py_IsInitialized()) return;
+    PyGILState_STATE gil = PyGILState_Ensure();
+    PyObject* dtArg = NULL;
+    for(int i = 0; i < pyHookCount; i++){
+        PythonHooks* h = &pyHooks[i];
+        if(strcmp(h->project, currentProject) != 0) continue;
+        if(!h->started){
+            h->started = true;
+            if(h->onStart){
+                PyObject* r = PyObject_CallNoArgs(h->onStart);
+                if(r) Py_DECREF(r); else PythonHookFailed(h, &h->onStart, "on_start");
+            }
+        }
+        for(int k = 0; k < collision.eventCount && h->onCollision; k++){
+            const CollisionEvent* e = &collision.events[k];
+            if(!e->began) continue;
+            PyObject* r = PyObject_CallFunction(h->onCollision, "II", e->a, e->b);
+            if(r) Py_DECREF(r); else PythonHookFailed(h, &h->onCollision, "on_collision");
+        }
+        if(!h->onUpdate) continue;
+        if(!dtArg && !(dtArg = PyFloat_FromDouble(dt))) break;
+        PyObject* r = PyObject_CallOneArg(h->onUpdate, dtArg);
+        if(r) Py_DECREF(r); else PythonHookFailed(h, &h->onUpdate, "on_update");
+    }
+    Py_XDECREF(dtArg);
+    if(PyErr_Occurred()) PyErr_Print();
+    PyGILState_Release(gil);
+}
+
+// Execute Python script and capture commands
+    static void RunPythonFile(const char* scriptName) {
+        // Build the full file path
+        char scriptPath[256];
+        snprintf(scriptPath, sizeof(scriptPath), "./Projects/%s/scripts/%s", currentProject, scriptName);
+        
+        // Check if file exists
+        struct stat st;
+        if(stat(scriptPath, &st) != 0) {
+            AddLog("Python script file '%s' not found at path: %s", scriptName, scriptPath);
+            return;
+        }
+        
+        // Clear previous commands
+        PyRun_SimpleString("game_commands.clear()");
+        
+        // Compiled once, then reused until the file changes
+        PyObject* code = GetPythonCode(currentProject, scriptName, scriptPath);
+        if(!code) {
+            PyErr_Print();
+            AddLog("Python script compilation failed for '%s'", scriptName);
+            return;
+        }
+        
+        // Execute the Python script in its persistent namespace
+        PyObject* globals = PythonScriptGlobals(currentProject, scriptName);
+        if(!globals) {
+            PyErr_Print();
+            return;
+        }
+        PyObject* result = PyEval_EvalCode(code, globals, globals);
+        if(!result) {
+            PyErr_Print();
+            AddLog("Python script execution failed for '%s'", scriptName);
+            return;
+        }
+        Py_DECREF(result);
+        RegisterPythonHooks(currentProject, scriptName);
+        
+        // Get and execute the generated commands
+        DispatchPythonCommands();
+        ApplyObjectChanges();
+        
+        AddLog("Executed Python script '%s' from project '%s'", scriptName, currentProject);
+    }
+
+// Takes the GIL, which the window's main thread doesn't hold while the simulation thread runs
+static void ExecutePythonScript(const char* scriptName){
+    PROFILE_SCOPE(PZ_EXEC_PYTHON);
+    if(!Py_IsInitialized()){ AddLog("Error: Python is not initialized"); return; }
+    PyGILState_STATE gil = PyGILState_Ensure();
+    RunPythonFile(scriptName);
+    PyGILState_Release(gil);
+}
+
+// --- Script loader ---
+// Background thread that reads the project's scripts folder, then watches it
+// (inotify on Linux, a rescan every SCRIPT_POLL_MS elsewhere) and re-reads
+// only files that changed. Results are queued as ScriptUpdates; the main
+// thread swaps the whole queue in between frames and compiles there, since
+// compiling interns variables.
+typedef struct {
+    char name[NAME_LEN];
+    TextBuffer* text;       // NULL when the file was removed
+    unsigned int request;   // LoadScripts call the update belongs to
+} ScriptUpdate;
+
+// What the loader last read of one file
+typedef struct {
+    char name[NAME_LEN];
+    long long mtime;
+    long size;
+    bool seen;
+} ScriptFileState;
+
+typedef struct {
+    char dir[256];
+    unsigned int request;
+    ScriptFileState* files;
+    int fileCount, fileCapacity;
+} ScriptScan;
+
+static pthread_t scriptLoaderThread;
+static pthread_mutex_t scriptLoaderLock = PTHREAD_MUTEX_INITIALIZER; // Guards the fields below
+static pthread_cond_t scriptLoaderWake = PTHREAD_COND_INITIALIZER;
+static bool scriptLoaderRunning = false, scriptLoaderStop = false;
+static char scriptLoaderDir[256] = "";
+static unsigned int scriptLoadRequest = 0;  // Bumped by LoadScripts
+static unsigned int scriptLoadDone = 0;     // Last request whose first scan is fully queued
+static ScriptUpdate* scriptUpdates = NULL;
+static int scriptUpdateCount = 0, scriptUpdateCapacity = 0;
+
+static void QueueScriptUpdate(const char* name, TextBuffer* text, unsigned int request){
+    pthread_mutex_lock(&scriptLoaderLock);
+    ScriptUpdate* u = NULL;
+    for(int i = 0; i < scriptUpdateCount; i++)
+        if(scriptUpdates[i].request == request && strcmp(scriptUpdates[i].name, name) == 0){ u = &scriptUpdates[i]; break; }
+    if(u) TextBufferRelease(u->text); // Superseded before the main thread took it
+    else if(scriptUpdateCount < scriptUpdateCapacity ||
+            GrowArray((void**)&scriptUpdates, scriptUpdateCapacity = scriptUpdateCapacity ? scriptUpdateCapacity*2 : 64, sizeof(ScriptUpdate), MEM_SCRIPTS)){
+        u = &scriptUpdates[scriptUpdateCount++];
+        memset(u, 0, sizeof(*u));
+        strncpy(u->name, name, NAME_LEN-1);
+        u->request = request;
+    }
+    if(u) u->text = text;
+    else TextBufferRelease(text);
+    pthread_mutex_unlock(&scriptLoaderLock);
+}
+
+static ScriptFileState* FindScriptFileState(ScriptScan* sc, const char* name){
+    for(int i = 0; i < sc->fileCount; i++) if(strcmp(sc->files[i].name, name) == 0) return &sc->files[i];
+    return NULL;
+}
+
+static void ForgetScriptFile(ScriptScan* sc, ScriptFileState* f){
+    QueueScriptUpdate(f->name, NULL, sc->request);
+    *f = sc->files[--sc->fileCount];
+}
+
+// Re-reads one file if its size or mtime changed, or reports it removed
+static void CheckScriptFile(ScriptScan* sc, const char* name){
+    if(name[0] == '.' || strlen(name) >= NAME_LEN) return; // Hidden editor temp files
+    char path[300]; snprintf(path, sizeof(path), "%s/%s", sc->dir, name);
+    ScriptFileState* f = FindScriptFileState(sc, name);
+    struct stat st;
+    if(stat(path, &st) != 0 || !S_ISREG(st.st_mode)){
+        if(f) ForgetScriptFile(sc, f);
+        return;
+    }
+    if(f){
+        f->seen = true;
+        if(f->mtime == FileMTime(&st) && f->size == (long)st.st_size) return;
+    } else {
+        if(sc->fileCount == sc->fileCapacity){
+            int cap = sc->fileCapacity ? sc->fileCapacity*2 : 64;
+            if(!GrowArray((void**)&sc->files, cap, sizeof(ScriptFileState), MEM_SCRIPTS)) return;
+            sc->fileCapacity = cap;
+        }
+        f = &sc->files[sc->fileCount++];
+        memset(f, 0, sizeof(*f));
+        strncpy(f->name, name, NAME_LEN-1);
+        f->seen = true;
+    }
+    f->mtime = FileMTime(&st);
+    f->size = (long)st.st_size;
+    TextBuffer* text = TextBufferLoad(path);
+    if(text) QueueScriptUpdate(name, text, sc->request);
+    else AddLog("Error: cannot read script '%s'", path);
+}
+
+// Checks every file in the folder; false if the folder doesn't exist
+static bool RescanScripts(ScriptScan* sc){
+    DIR* dir = opendir(sc->dir);
+    if(!dir) return false;
+    for(int i = 0; i < sc->fileCount; i++) sc->files[i].seen = false;
+    struct dirent* entry;
+    while((entry = readdir(dir)) != NULL) CheckScriptFile(sc, entry->d_name);
+    closedir(dir);
+    for(int i = sc->fileCount-1; i >= 0; i--) if(!sc->files[i].seen) ForgetScriptFile(sc, &sc->files[i]);
+    return true;
+}
+
+#ifdef __linux__
+static void ReadScriptEvents(ScriptScan* sc, int fd, int watch){
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    bool rescan = false;
+    while((len = read(fd, buf, sizeof(buf))) > 0){
+        for(char* p = buf; p < buf + len;){
+            const struct inotify_event* ev = (const struct inotify_event*)p;
+            if(ev->mask & IN_Q_OVERFLOW) rescan = true;
+            else if(ev->wd == watch && ev->len) CheckScriptFile(sc, ev->name);
+            p += sizeof(*ev) + ev->len;
+        }
+    }
+    if(rescan) RescanScripts(sc);
+}
+#endif
+
+static void* ScriptLoaderMain(void* arg){
+    ScriptScan sc = {0};
+    int fd = -1, watch = -1;
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    const unsigned int watchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+#endif
+    double lastScan = 0;
+    for(;;){
+        pthread_mutex_lock(&scriptLoaderLock);
+        bool stop = scriptLoaderStop;
+        bool restart = sc.request != scriptLoadRequest;
+        if(restart){ sc.request = scriptLoadRequest; memcpy(sc.dir, scriptLoaderDir, sizeof(sc.dir)); }
+        pthread_mutex_unlock(&scriptLoaderLock);
+        if(stop) break;
+
+        if(restart){
+#ifdef __linux__
+            if(watch >= 0) inotify_rm_watch(fd, watch);
+            watch = fd >= 0 ? inotify_add_watch(fd, sc.dir, watchMask) : -1;
+#endif
+            sc.fileCount = 0;
+            if(!RescanScripts(&sc)) AddLog("No scripts folder");
+            lastScan = NowSeconds();
+            pthread_mutex_lock(&scriptLoaderLock);
+            scriptLoadDone = sc.request;
+            pthread_mutex_unlock(&scriptLoaderLock);
+            continue;
+        }
+#ifdef __linux__
+        if(watch >= 0){
+            struct pollfd p = { fd, POLLIN, 0 };
+            if(poll(&p, 1, 50) > 0) ReadScriptEvents(&sc, fd, watch);
+            continue;
+        }
+#endif
+        pthread_mutex_lock(&scriptLoaderLock);
+        if(!scriptLoaderStop && sc.request == scriptLoadRequest){
+            struct timespec wake; clock_gettime(CLOCK_REALTIME, &wake);
+            wake.tv_nsec += 50*1000000L;
+            if(wake.tv_nsec >= 1000000000L){ wake.tv_sec++; wake.tv_nsec -= 1000000000L; }
+            pthread_cond_timedwait(&scriptLoaderWake, &scriptLoaderLock, &wake);
+        }
+        pthread_mutex_unlock(&scriptLoaderLock);
+        if(NowSeconds() - lastScan >= SCRIPT_POLL_MS / 1000.0){
+#ifdef __linux__
+            if(fd >= 0) watch = inotify_add_watch(fd, sc.dir, watchMask); // The folder may exist now
+#endif
+            RescanScripts(&sc);
+            lastScan = NowSeconds();
+        }
+    }
+    if(fd >= 0) close(fd);
+    MemFree(sc.files);
+    return NULL;
+}
+
+static void StartScriptLoader(void){
+    if(scriptLoaderRunning) return;
+    scriptLoaderStop = false;
+    scriptLoaderRunning = pthread_create(&scriptLoaderThread, NULL, ScriptLoaderMain, NULL) == 0;
+    if(!scriptLoaderRunning) AddLog("Error: script loader could not start");
+}
+
+static void StopScriptLoader(void){
+    if(!scriptLoaderRunning) return;
+    pthread_mutex_lock(&scriptLoaderLock);
+    scriptLoaderStop = true;
+    pthread_cond_signal(&scriptLoaderWake);
+    pthread_mutex_unlock(&scriptLoaderLock);
+    pthread_join(scriptLoaderThread, NULL);
+    scriptLoaderRunning = false;
+    for(int i = 0; i < scriptUpdateCount; i++) TextBufferRelease(scriptUpdates[i].text);
+    scriptUpdateCount = 0;
+}
+
+// Drops the loaded scripts and has the loader read the project's folder;
+// the scripts arrive through ApplyScriptUpdates over the next frames
+static void LoadScripts(const char* projectName){
+    for(int i=0;i<scriptCount;i++){ TextBufferRelease(scripts[i].text); scripts[i].text=NULL; FreeProgram(&scripts[i].program); }
+    scriptCount = 0;
+    pthread_mutex_lock(&scriptLoaderLock);
+    snprintf(scriptLoaderDir, sizeof(scriptLoaderDir), "./Projects/%s/scripts", projectName);
+    scriptLoadRequest++;
+    pthread_cond_signal(&scriptLoaderWake);
+    pthread_mutex_unlock(&scriptLoaderLock);
+    StartScriptLoader();
+}
+
+static bool TextBufferEquals(TextBuffer* a, TextBuffer* b){
+    if(TextLineCount(a) != TextLineCount(b)) return false;
+    for(int i = 0; i < TextLineCount(a); i++)
+        if(TextLineLength(a, i) != TextLineLength(b, i) || memcmp(TextLineStr(a, i), TextLineStr(b, i), TextLineLength(a, i)) != 0) return false;
+    return true;
+}
+
+// Points unmodified editor tabs of a reloaded file at its new text
+static void ReloadEditors(const char* name, TextBuffer* text){
+    for(int i = 0; i < openCount; i++){
+        ScriptEditor* ed = &openEditors[i];
+        if(strcmp(ed->name, name) != 0 || ed->text == text) continue;
+        if(ed->modified){ AddLog("Warning: '%s' changed on disk; saving the open tab will overwrite it", name); continue; }
+        TextBufferRelease(ed->text);
+        ed->text = TextBufferRetain(text);
+        if(TextLineCount(ed->text) == 0) TextBufferInsertLine(ed->text, 0, "", 0); // The caret needs a line
+        if(i == activeEditor){
+            caretLine = Clamp(caretLine, 0, TextLineCount(ed->text) - 1);
+            caretCol = Clamp(caretCol, 0, TextLineLength(ed->text, caretLine));
+        }
+    }
+}
+
+// Editor and overlay commands that Python hooks queue during a tick would
+// change tabs the main thread draws after releasing worldLock, so the
+// simulation thread hands them over and the main thread runs them here
+static _Thread_local bool onSimulationThread;
+static pthread_mutex_t uiCommandLock = PTHREAD_MUTEX_INITIALIZER;
+static char** uiCommands = NULL;
+static int uiCommandCount = 0, uiCommandCapacity = 0;
+
+static bool IsUiCommand(const char* word){
+    return strcmp(word, "OpenScript") == 0 || strcmp(word, "NewScript") == 0 ||
+           strcmp(word, "NewPython") == 0 || strcmp(word, "profile") == 0;
+}
+
+static void QueueUiCommand(const char* cmd){
+    size_t len = strlen(cmd);
+    char* copy = MemAlloc(MEM_EDITOR, len + 1);
+    if(!copy){ AddLog("Error: out of memory queueing '%s'", cmd); return; }
+    memcpy(copy, cmd, len + 1);
+    pthread_mutex_lock(&uiCommandLock);
+    if(uiCommandCount == uiCommandCapacity){
+        int cap = uiCommandCapacity ? uiCommandCapacity*2 : 16;
+        if(!GrowArray((void**)&uiCommands, cap, sizeof(char*), MEM_EDITOR)){
+            pthread_mutex_unlock(&uiCommandLock);
+            MemFree(copy);
+            AddLog("Error: out of memory queueing '%s'", cmd);
+            return;
+        }
+        uiCommandCapacity = cap;
+    }
+    uiCommands[uiCommandCount++] = copy;
+    pthread_mutex_unlock(&uiCommandLock);
+}
+
+static void RunUiCommands(void){
+    pthread_mutex_lock(&uiCommandLock);
+    char** commands = uiCommands;
+    int count = uiCommandCount;
+    uiCommands = NULL; uiCommandCount = uiCommandCapacity = 0;
+    pthread_mutex_unlock(&uiCommandLock);
+    for(int k = 0; k < count; k++){ ExecuteCommand(commands[k]); MemFree(commands[k]); }
+    MemFree(commands);
+}
+
+// Swaps in everything the loader queued since the last call, all at once,
+// then runs the editor commands the simulation thread handed over
+static void ApplyScriptUpdates(void){
+    RunUiCommands();
+    pthread_mutex_lock(&scriptLoaderLock);
+    if(scriptUpdateCount == 0){ pthread_mutex_unlock(&scriptLoaderLock); return; }
+    ScriptUpdate* updates = scriptUpdates;
+    int count = scriptUpdateCount;
+    scriptUpdates = NULL; scriptUpdateCount = scriptUpdateCapacity = 0;
+    pthread_mutex_unlock(&scriptLoaderLock);
+
+    for(int k = 0; k < count; k++){
+        ScriptUpdate* u = &updates[k];
+        Script* s = FindScript(u->name);
+        if(u->request != scriptLoadRequest){ TextBufferRelease(u->text); continue; } // From a project left since
+        if(!u->text){
+            if(s){ RemoveScript(s); AddLog("Removed script '%s'", u->name); }
+            continue;
+        }
+        if(s && s->text && TextBufferEquals(s->text, u->text)){ TextBufferRelease(u->text); continue; } // Our own save
+        bool reloaded = s != NULL;
+        if(!s && !(s = AddScript(u->name))){ TextBufferRelease(u->text); continue; }
+        ReloadEditors(s->name, u->text);
+        TextBufferRelease(s->text);
+        s->text = u->text;
+        CompileScript(s);
+        const char* typeStr = s->isPython ? "Python script" : (s->isScript ? "custom script" : "file");
+        AddLog("%s %s '%s'", reloaded ? "Reloaded" : "Loaded", typeStr, s->name);
+        // Scripts with live hooks re-run so the new definitions take over
+        if(reloaded && s->isPython && FindPythonHooks(currentProject, s->name)){
+            char name[NAME_LEN]; memcpy(name, s->name, NAME_LEN);
+            ExecutePythonScript(name);
+        }
+    }
+    MemFree(updates);
+}
+
+// Blocks until the first scan of the current project is swapped in (headless runs)
+static void WaitForScripts(void){
+    for(;;){
+        pthread_mutex_lock(&scriptLoaderLock);
+        bool done = scriptLoadDone == scriptLoadRequest;
+        pthread_mutex_unlock(&scriptLoaderLock);
+        ApplyScriptUpdates();
+        if(done || !scriptLoaderRunning) return;
+        struct timespec ts = { 0, 1000000L };
+        nanosleep(&ts, NULL);
+    }
+}
+
+// --- Simulation tick ---
+// Per-phase wall time of one tick; headless mode accumulates these
+typedef struct {
+    double scripts;
+    double variables;
+    double python;
+    double motion;
+    double collisions;
+} TickTimings;
+
+// One step of the work the Run button enables: every loaded non-.script
+// file line by line, the angle animation, then Python hooks and queued commands
+static void SimulationTick(TickTimings* timings) {
+    ProfileBegin(PZ_TICK);
+    double t0 = timings ? NowSeconds() : 0;
+    ProfileBegin(PZ_SCRIPTS);
+    for(int s=0;s<scriptCount;s++){
+        Script *sc=&scripts[s];
+        if(sc->isScript) {
+            // Skip scripts in auto-run mode - use F5 or RunScript command instead
+            continue;
+        } else {
+            RunProgram(&sc->program, false);
+        }
+    }
+    ProfileEnd();
+    double t1 = timings ? NowSeconds() : 0;
+
+    // Update variables for animation
+    ProfileBegin(PZ_ANGLE);
+    static int angleSlot = -1;
+    if(angleSlot < 0) angleSlot = InternVariable("angle");
+    float currentAngle = VariableValue(angleSlot, 0);
+    SetVariableValue(angleSlot, 0, currentAngle > 360 ? 0 : currentAngle + 2.0f);
+    ProfileEnd();
+    double t2 = timings ? NowSeconds() : 0;
+
+    ProfileBegin(PZ_PYTHON);
+    RunPythonHooks(1.0 / SIM_TICK_RATE);
+    DispatchPythonCommands();
+    ApplyObjectChanges();
+    ProfileEnd();
+    double t3 = timings ? NowSeconds() : 0;
+    ProfileBegin(PZ_MOTION);
+    IntegrateMotion(1.0f / SIM_TICK_RATE);
+    ProfileEnd();
+    double t4 = timings ? NowSeconds() : 0;
+    if(collision.enabled){ ProfileBegin(PZ_COLLISIONS); DetectCollisions(); ProfileEnd(); }
+    simTime += 1.0 / SIM_TICK_RATE;
+
+    if(timings) {
+        timings->scripts += t1 - t0;
+        timings->variables += t2 - t1;
+        timings->python += t3 - t2;
+        timings->motion += t4 - t3;
+        timings->collisions += NowSeconds() - t4;
+    }
+    ProfileEnd();
+}
+
+// --- Editor Utilities ---
+static void OpenScriptTab(const char* name){
+    for(int i=0;i<openCount;i++){ if(strcmp(openEditors[i].name,name)==0){ activeEditor=i; return; } }
+    if(openCount == openCapacity){
+        int cap = openCapacity ? openCapacity*2 : 8;
+        if(!GrowArray((void**)&openEditors, cap, sizeof(ScriptEditor), MEM_EDITOR)){ AddLog("Error: out of memory opening '%s'", name); return; }
+        openCapacity = cap;
+    }
+    ScriptEditor* ed=&openEditors[openCount];
+    strncpy(ed->name,name,NAME_LEN-1); ed->scroll=0;
+    ed->text=NULL;
+    ed->modified=false;
+    
+    // Check file type
+    ed->isScript = (strstr(name, ".script") != NULL);
+    ed->isPython = (strstr(name, ".py") != NULL);
+    
+    // Load from existing script if found
+    for(int i=0;i<scriptCount;i++) if(strcmp(scripts[i].name,name)==0){
+        ed->isScript = scripts[i].isScript;
+        ed->isPython = scripts[i].isPython;
+        ed->text = TextBufferRetain(scripts[i].text);
+        break;
+    }
+    if(!ed->text && !(ed->text = TextBufferNew())){ AddLog("Error: out of memory opening '%s'", name); return; }
+    if(TextLineCount(ed->text) == 0) TextBufferInsertLine(ed->text, 0, "", 0); // The caret needs a line
+    activeEditor=openCount;
+    openCount++;
+    caretLine = 0;
+    caretCol = 0;
+    const char* typeStr = ed->isPython ? "Python script" : (ed->isScript ? "custom script" : "file");
+    AddLog("Opened %s '%s'", typeStr, name);
+}
+
+// --- Batched renderer ---
+// Canvas shapes are tessellated into per-frame triangle lists and pushed to
+// rlgl in a few large rlBegin/rlEnd runs instead of several raylib calls per
+// object. Layers: shapes (selection, outline, fill, in object order), then
+// label backgrounds, then label text (raylib batches glyphs per font texture).
+#define CIRCLE_SEGMENTS 64
+#define RENDER_CHUNK_VERTICES (3*(RL_DEFAULT_BATCH_BUFFER_ELEMENTS*4/3)) // Whole triangles per rlgl batch
+
+typedef struct { Vector2 p; Color c; } BatchVertex;
+
+typedef struct {
+    BatchVertex* v;
+    int count, capacity;
+} VertexBatch;
+
+typedef struct {
+    int shapes, labels;
+    int vertices;
+    int drawCalls;   // rlgl batch submissions (plus one for the label text)
+} RenderStats;
+
+// What the window draws, copied out of the live store after every tick: the
+// objects in view plus the side panel contents. The simulation thread fills
+// the back frame and swaps it with the ready one; the renderer swaps the
+// ready frame to the front when there is a newer one. Neither side waits
+// for the other, and the renderer never reads the live store. Editor tabs
+// are drawn straight from their state, which only the main thread changes.
+#define PANEL_OBJECTS 8
+#define PANEL_VARIABLES 6
+
+typedef struct {
+    int count, capacity;          // Objects in view, in store order
+    Vector2* position;            // After the newest tick
+    Vector2* previous;            // Before it; drawn in between
+    float* size;
+    Color* color;
+    unsigned char* shape;
+    bool* selected;
+    char (*name)[NAME_LEN];       // Empty for objects drawn without a label
+    float* labelWidth;
+    int objectCount;              // Whole scene
+    int panelCount;               // First objects, for the side panel
+    char panelName[PANEL_OBJECTS][NAME_LEN];
+    Color panelColor[PANEL_OBJECTS];
+    unsigned char panelShape[PANEL_OBJECTS];
+    bool panelSelected[PANEL_OBJECTS];
+    int variableLines;
+    char variableText[PANEL_VARIABLES][64];
+    double time;                  // Wall clock the newest tick ends at
+    bool interpolate;             // False when no tick ran (paused)
+} SceneFrame;
+
+static VertexBatch shapeBatch = {0}, labelBatch = {0};
+static RenderStats renderStats = {0};
+static Vector2 unitCircle[CIRCLE_SEGMENTS+1];
+
+// Name labels: widths are measured once per object and font. Bump
+// fontEpoch whenever the UI font changes to re-measure labels and editor lines.
+#define LABEL_FONT_SIZE 12
+static unsigned int fontEpoch = 1;
+static bool labelsVisible = true;
+static float labelMinSize = 0;   // Objects smaller than this draw without a label
+
+static float ObjectLabelWidth(int i, Font font){
+    if(objects.labelEpoch[i] != fontEpoch){
+        objects.labelWidth[i] = MeasureTextEx(font, objects.name[i], LABEL_FONT_SIZE, 0).x;
+        objects.labelEpoch[i] = fontEpoch;
+    }
+    return objects.labelWidth[i];
+}
+
+static BatchVertex* BatchAlloc(VertexBatch* b, int n){
+    if(b->count + n > b->capacity){
+        int cap = b->capacity ? b->capacity : 4096;
+        while(cap < b->count + n) cap *= 2;
+        if(!GrowArray((void**)&b->v, cap, sizeof(BatchVertex), MEM_RENDER)) return NULL;
+        b->capacity = cap;
+    }
+    BatchVertex* v = b->v + b->count;
+    b->count += n;
+    return v;
+}
+
+static void BatchQuad(VertexBatch* b, float x0, float y0, float x1, float y1, Color c){
+    BatchVertex* v = BatchAlloc(b, 6);
+    if(!v) return;
+    v[0] = (BatchVertex){{x0,y0},c}; v[1] = (BatchVertex){{x0,y1},c}; v[2] = (BatchVertex){{x1,y1},c};
+    v[3] = (BatchVertex){{x0,y0},c}; v[4] = (BatchVertex){{x1,y1},c}; v[5] = (BatchVertex){{x1,y0},c};
+}
+
+// Fewer segments for small circles; step indexes unitCircle
+static int CircleStep(float r){ return r < 8 ? 4 : r < 32 ? 2 : 1; }
+
+static void BatchDisc(VertexBatch* b, Vector2 center, float r, Color c){
+    int step = CircleStep(r);
+    BatchVertex* v = BatchAlloc(b, 3*CIRCLE_SEGMENTS/step);
+    if(!v) return;
+    for(int s = 0; s < CIRCLE_SEGMENTS; s += step){
+        *v++ = (BatchVertex){center, c};
+        *v++ = (BatchVertex){{center.x + unitCircle[s+step].x*r, center.y + unitCircle[s+step].y*r}, c};
+        *v++ = (BatchVertex){{center.x + unitCircle[s].x*r, center.y + unitCircle[s].y*r}, c};
+    }
+}
+
+static void BatchRing(VertexBatch* b, Vector2 center, float inner, float outer, Color c){
+    int step = CircleStep(outer);
+    BatchVertex* v = BatchAlloc(b, 6*CIRCLE_SEGMENTS/step);
+    if(!v) return;
+    for(int s = 0; s < CIRCLE_SEGMENTS; s += step){
+        Vector2 a = unitCircle[s], d = unitCircle[s+step];
+        Vector2 ai = {center.x + a.x*inner, center.y + a.y*inner}, ao = {center.x + a.x*outer, center.y + a.y*outer};
+        Vector2 di = {center.x + d.x*inner, center.y + d.y*inner}, dout = {center.x + d.x*outer, center.y + d.y*outer};
+        *v++ = (BatchVertex){ai,c}; *v++ = (BatchVertex){dout,c}; *v++ = (BatchVertex){ao,c};
+        *v++ = (BatchVertex){ai,c}; *v++ = (BatchVertex){di,c};   *v++ = (BatchVertex){dout,c};
+    }
+}
+
+static void BatchFrame(VertexBatch* b, float x0, float y0, float x1, float y1, float t, Color c){
+    BatchQuad(b, x0, y0, x1, y0+t, c);
+    BatchQuad(b, x0, y1-t, x1, y1, c);
+    BatchQuad(b, x0, y0+t, x0+t, y1-t, c);
+    BatchQuad(b, x1-t, y0+t, x1, y1-t, c);
+}
+
+static void BatchObject(VertexBatch* b, const SceneFrame* f, int i, float alpha){
+    Vector2 pos = Vector2Lerp(f->previous[i], f->position[i], alpha); float size = f->size[i]; Color col = f->color[i];
+    if(f->shape[i] == SHAPE_CIRCLE){
+        if(f->selected[i]) BatchRing(b, pos, size+4, size+5, ACCENT_BLUE);
+        // Opaque fills cover a dark disc one pixel larger; that disc is the outline
+        if(col.a == 255){ BatchDisc(b, pos, size, DARKGRAY); BatchDisc(b, pos, size-1, col); }
+        else { BatchDisc(b, pos, size, col); BatchRing(b, pos, size-1, size, DARKGRAY); }
+    } else {
+        if(f->selected[i]) BatchFrame(b, pos.x-size-5, pos.y-size-5, pos.x+size+5, pos.y+size+5, 2, ACCENT_BLUE);
+        if(col.a == 255){
+            BatchQuad(b, pos.x-size, pos.y-size, pos.x+size, pos.y+size, DARKGRAY);
+            BatchQuad(b, pos.x-size+1, pos.y-size+1, pos.x+size-1, pos.y+size-1, col);
+        } else {
+            BatchQuad(b, pos.x-size, pos.y-size, pos.x+size, pos.y+size, col);
+            BatchFrame(b, pos.x-size, pos.y-size, pos.x+size, pos.y+size, 1, DARKGRAY);
+        }
+    }
+}
+
+typedef struct { const SceneFrame* frame; float alpha; } ShapeBatchJob;
+static VertexBatch shapeChunks[JOB_MAX_CHUNKS];
+
+static void ShapeBatchChunk(void* data, int chunk, int begin, int end){
+    const ShapeBatchJob* job = data;
+    VertexBatch* b = &shapeChunks[chunk];
+    b->count = 0;
+    for(int i = begin; i < end; i++) BatchObject(b, job->frame, i, job->alpha);
+}
+
+// Tessellates a frame's objects, alpha of the way from previous to position.
+// Chunks are built in parallel and appended in object order.
+static void BuildShapeBatch(const SceneFrame* f, float alpha){
+    if(unitCircle[0].x == 0){
+        for(int s = 0; s <= CIRCLE_SEGMENTS; s++){
+            float a = (float)s/CIRCLE_SEGMENTS * 2*PI;
+            unitCircle[s] = (Vector2){cosf(a), sinf(a)};
+        }
+    }
+    ShapeBatchJob job = { f, alpha };
+    int chunks = ParallelFor(f->count, 256, ShapeBatchChunk, &job);
+    shapeBatch.count = 0;
+    for(int c = 0; c < chunks; c++){
+        BatchVertex* v = BatchAlloc(&shapeBatch, shapeChunks[c].count);
+        if(v) memcpy(v, shapeChunks[c].v, (size_t)shapeChunks[c].count * sizeof(BatchVertex));
+    }
+    renderStats.shapes = f->count;
+}
+
+// Sends a layer to rlgl in chunks that fit its vertex buffer; returns the
+// number of submissions. Without submit only counts (headless).
+static int FlushBatch(VertexBatch* b, bool submit){
+    int calls = 0;
+    for(int first = 0; first < b->count; first += RENDER_CHUNK_VERTICES){
+        int n = b->count - first < RENDER_CHUNK_VERTICES ? b->count - first : RENDER_CHUNK_VERTICES;
+        calls++;
+        if(!submit) continue;
+        rlCheckRenderBatchLimit(n);
+        rlBegin(RL_TRIANGLES);
+        for(const BatchVertex* v = b->v + first; v < b->v + first + n; v++){
+            rlColor4ub(v->c.r, v->c.g, v->c.b, v->c.a);
+            rlVertex2f(v->p.x, v->p.y);
+        }
+        rlEnd();
+    }
+    renderStats.vertices += b->count;
+    renderStats.drawCalls += calls;
+    return calls;
+}
+
+// --- Scene frames ---
+static SceneFrame sceneFrames[3];
+static SceneFrame* frontFrame = &sceneFrames[0];  // Renderer
+static SceneFrame* readyFrame = &sceneFrames[1];  // Newest complete frame
+static SceneFrame* backFrame = &sceneFrames[2];   // Simulation thread
+static bool readyFrameFresh = false;
+static Rectangle frameView = HEADLESS_CANVAS;     // Canvas the renderer last asked for
+static pthread_mutex_t frameLock = PTHREAD_MUTEX_INITIALIZER; // Guards the four above
+static Font labelFont;                            // UI font, for label widths
+
+static bool SceneFrameReserve(SceneFrame* f, int needed){
+    if(needed <= f->capacity) return true;
+    int cap = f->capacity ? f->capacity : 256;
+    while(cap < needed) cap *= 2;
+    if(!GrowArray((void**)&f->position, cap, sizeof(Vector2), MEM_RENDER) ||
+       !GrowArray((void**)&f->previous, cap, sizeof(Vector2), MEM_RENDER) ||
+       !GrowArray((void**)&f->size, cap, sizeof(float), MEM_RENDER) ||
+       !GrowArray((void**)&f->color, cap, sizeof(Color), MEM_RENDER) ||
+       !GrowArray((void**)&f->shape, cap, sizeof(unsigned char), MEM_RENDER) ||
+       !GrowArray((void**)&f->selected, cap, sizeof(bool), MEM_RENDER) ||
+       !GrowArray((void**)&f->name, cap, NAME_LEN, MEM_RENDER) ||
+       !GrowArray((void**)&f->labelWidth, cap, sizeof(float), MEM_RENDER)) return false;
+    f->capacity = cap;
+    return true;
+}
+
+typedef struct { SceneFrame* frame; const int* visible; bool interpolate; } SceneFrameJob;
+
+// Visible objects are distinct, so chunks write disjoint frame rows and label caches
+static void SceneFrameChunk(void* data, int chunk, int begin, int end){
+    const SceneFrameJob* job = data;
+    SceneFrame* f = job->frame;
+    for(int k = begin; k < end; k++){
+        int i = job->visible[k];
+        f->position[k] = objects.position[i];
+        f->previous[k] = job->interpolate ? objects.previous[i] : objects.position[i];
+        f->size[k] = objects.size[i];
+        f->color[k] = objects.color[i];
+        f->shape[k] = objects.shape[i];
+        f->selected[k] = objects.selected[i];
+        if(labelsVisible && objects.size[i] >= labelMinSize){
+            memcpy(f->name[k], objects.name[i], NAME_LEN);
+            f->labelWidth[k] = ObjectLabelWidth(i, labelFont);
+        } else f->name[k][0] = '\0';
+    }
+}
+
+// Copies what the renderer needs from the live store; the caller holds worldLock
+static void BuildSceneFrame(SceneFrame* f, Rectangle view, bool interpolate){
+    PROFILE_SCOPE(PZ_SCENE_FRAME);
+    static int* visible = NULL; static int visibleCap = 0;
+    int n = QueryVisibleObjects(view, &visible, &visibleCap);
+    if(!SceneFrameReserve(f, n)) n = 0;
+    f->count = n;
+    SceneFrameJob job = { f, visible, interpolate };
+    ParallelFor(n, 1024, SceneFrameChunk, &job);
+    f->objectCount = objects.count;
+    f->panelCount = objects.count < PANEL_OBJECTS ? objects.count : PANEL_OBJECTS;
+    for(int i = 0; i < f->panelCount; i++){
+        memcpy(f->panelName[i], objects.name[i], NAME_LEN);
+        f->panelColor[i] = objects.color[i];
+        f->panelShape[i] = objects.shape[i];
+        f->panelSelected[i] = objects.selected[i];
+    }
+    f->variableLines = 0;
+    for(int i = 0; i < variableCount && f->variableLines < PANEL_VARIABLES; i++)
+        if(variables[i].defined) FormatVariable(&variables[i], f->variableText[f->variableLines++], sizeof(f->variableText[0]));
+    f->interpolate = interpolate;
+}
+
+static Rectangle SceneFrameView(void){
+    pthread_mutex_lock(&frameLock);
+    Rectangle view = frameView;
+    pthread_mutex_unlock(&frameLock);
+    return view;
+}
+
+// Hands the back frame over as the newest one
+static void PublishSceneFrame(double time){
+    backFrame->time = time;
+    pthread_mutex_lock(&frameLock);
+    SceneFrame* t = readyFrame; readyFrame = backFrame; backFrame = t;
+    readyFrameFresh = true;
+    pthread_mutex_unlock(&frameLock);
+}
+
+// The newest published frame; also records the canvas for the next ones
+static SceneFrame* AcquireSceneFrame(Rectangle view){
+    pthread_mutex_lock(&frameLock);
+    if(readyFrameFresh){
+        SceneFrame* t = frontFrame; frontFrame = readyFrame; readyFrame = t;
+        readyFrameFresh = false;
+    }
+    frameView = view;
+    pthread_mutex_unlock(&frameLock);
+    return frontFrame;
+}
+
+// --- Simulation thread ---
+// In the window, ticks run here at SIM_TICK_RATE whatever the frame rate.
+// worldLock guards the live state (objects, variables, scripts, journal,
+// Python): the simulation holds it per wake-up, the main thread while it
+// handles input and commands, and it is released while drawing.
+#define SIM_MAX_CATCHUP 5   // Ticks per wake-up before falling behind is accepted
+
+static pthread_mutex_t worldLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t simThread;
+static bool simThreadRunning = false;
+static atomic_bool simThreadStop;
+
+static void* SimulationMain(void* arg){
+    const double dt = 1.0 / SIM_TICK_RATE;
+    double next = NowSeconds() + dt;
+    ProfileRegisterThread("simulation");
+    onSimulationThread = true;
+    while(!atomic_load(&simThreadStop)){
+        double now = NowSeconds();
+        if(now < next){
+            double wait = next - now;
+            struct timespec ts = { (time_t)wait, (long)((wait - (time_t)wait) * 1e9) };
+            nanosleep(&ts, NULL);
+            continue;
+        }
+        Rectangle view = SceneFrameView();
+        ProfileBegin(PZ_LOCK_WAIT);
+        pthread_mutex_lock(&worldLock);
+        ProfileEnd();
+        bool ticked = false;
+        for(int steps = 0; now >= next && steps < SIM_MAX_CATCHUP; steps++){
+            if(running){
+                memcpy(objects.previous, objects.position, (size_t)objects.count * sizeof(Vector2));
+                SimulationTick(NULL);
+                ticked = true;
+            }
+            next += dt;
+        }
+        if(now >= next) next = now + dt; // Drop the backlog rather than spiral
+        BuildSceneFrame(backFrame, view, ticked);
+        pthread_mutex_unlock(&worldLock);
+        PublishSceneFrame(next - dt);
+    }
+    return NULL;
+}
+
+static void StartSimulationThread(void){
+    atomic_store(&simThreadStop, false);
+    simThreadRunning = pthread_create(&simThread, NULL, SimulationMain, NULL) == 0;
+    if(!simThreadRunning) AddLog("Error: simulation thread could not start");
+}
+
+static void StopSimulationThread(void){
+    if(!simThreadRunning) return;
+    atomic_store(&simThreadStop, true);
+    pthread_join(simThread, NULL);
+    simThreadRunning = false;
+}
+
+// --- Profiler output ---
+#define PROFILE_REFRESH 0.25        // Seconds between overlay summaries
+#define PROFILE_DUMP_FRAMES 120     // Frames `profile dump` writes by default
+
+typedef struct { float avg, p50, p95, max, perSecond; int samples; } ProfileSummary;
+
+static int CompareFloats(const void* a, const void* b){
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+static int CompareDoubles(const void* a, const void* b){
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Rolling statistics over each zone's last PROFILE_SAMPLES durations, in ms
+static void SummarizeProfile(ProfileSummary* out, double elapsed){
+    static unsigned int lastNext[PZ_COUNT];
+    float ms[PROFILE_SAMPLES];
+    for(int z = 0; z < PZ_COUNT; z++){
+        ProfileZoneStats* s = &profileStats[z];
+        unsigned int next = atomic_load_explicit(&s->next, memory_order_relaxed);
+        int n = next < PROFILE_SAMPLES ? (int)next : PROFILE_SAMPLES;
+        ProfileSummary* r = &out[z];
+        *r = (ProfileSummary){0};
+        r->samples = n;
+        r->perSecond = elapsed > 0 ? (float)((next - lastNext[z]) / elapsed) : 0;
+        lastNext[z] = next;
+        if(n == 0) continue;
+        double sum = 0;
+        for(int i = 0; i < n; i++){ ms[i] = atomic_load_explicit(&s->samples[i], memory_order_relaxed) * 1e-6f; sum += ms[i]; }
+        qsort(ms, n, sizeof(float), CompareFloats);
+        r->avg = (float)(sum / n);
+        r->p50 = ms[n / 2];
+        r->p95 = ms[(n * 95) / 100 < n ? (n * 95) / 100 : n - 1];
+        r->max = ms[n - 1];
+    }
+}
+
+// Zone table in the top-right corner of the canvas; toggled with F3 or `profile`
+static void DrawProfileOverlay(Font font, Rectangle canvas){
+    static ProfileSummary summary[PZ_COUNT];
+    static double lastRefresh = 0;
+    double now = NowSeconds();
+    if(now - lastRefresh >= PROFILE_REFRESH){
+        SummarizeProfile(summary, lastRefresh > 0 ? now - lastRefresh : 0);
+        lastRefresh = now;
+    }
+    static const char* columns[] = { "avg", "p50", "p95", "max", "/s" };
+    const float lineH = 14, colW = 48, nameW = 150;
+    int lines = 1;
+    for(int z = 0; z < PZ_COUNT; z++) if(summary[z].samples) lines++;
+    Rectangle box = { canvas.x + canvas.width - (nameW + 5*colW + 16), canvas.y + 8, nameW + 5*colW + 8, lines*lineH + 8 };
+    DrawRectangleRec(box, (Color){0, 0, 0, 190});
+    float y = box.y + 4;
+    DrawTextEx(font, "zone (ms)", (Vector2){box.x + 4, y}, 12, 0, TEXT_SECONDARY);
+    for(int c = 0; c < 5; c++) DrawTextEx(font, columns[c], (Vector2){box.x + nameW + c*colW, y}, 12, 0, TEXT_SECONDARY);
+    for(int z = 0; z < PZ_COUNT; z++){
+        const ProfileSummary* r = &summary[z];
+        if(!r->samples) continue;
+        y += lineH;
+        Color col = r->p95 > 1000.0f / SIM_TICK_RATE ? ACCENT_RED : r->p95 > 4.0f ? ACCENT_ORANGE : TEXT_PRIMARY;
+        DrawTextEx(font, profileZones[z].name, (Vector2){box.x + 4 + profileZones[z].indent*10, y}, 12, 0, col);
+        float values[5] = { r->avg, r->p50, r->p95, r->max, r->perSecond };
+        for(int c = 0; c < 5; c++){
+            char text[16]; snprintf(text, sizeof(text), c < 4 ? "%.2f" : "%.0f", values[c]);
+            DrawTextEx(font, text, (Vector2){box.x + nameW + c*colW, y}, 12, 0, col);
+        }
+    }
+}
+
+// Chrome trace-event JSON (chrome://tracing, Perfetto) of the last `frames`
+// Frame zones and every zone that ended during them, on every thread
+static bool WriteProfileTrace(const char* path, int frames){
+    ProfileThread* threads[PROFILE_MAX_THREADS];
+    pthread_mutex_lock(&profileThreadsLock);
+    int threadCount = profileThreadCount;
+    memcpy(threads, profileThreads, sizeof(threads));
+    pthread_mutex_unlock(&profileThreadsLock);
+
+    // Copy the rings out first so recording threads only wait on a memcpy
+    ProfileEvent* events[PROFILE_MAX_THREADS] = {0};
+    int counts[PROFILE_MAX_THREADS] = {0};
+    double* frameStarts = NULL;
+    int frameCount = 0, frameCap = 0;
+    bool ok = true;
+    for(int t = 0; t < threadCount && ok; t++){
+        ProfileThread* th = threads[t];
+        if(!(events[t] = MemAlloc(MEM_PROFILER, PROFILE_EVENTS * sizeof(ProfileEvent)))){ ok = false; break; }
+        pthread_mutex_lock(&th->lock);
+        unsigned int end = th->eventCount, n = end < PROFILE_EVENTS ? end : PROFILE_EVENTS;
+        for(unsigned int i = 0; i < n; i++) events[t][i] = th->events[(end - n + i) & (PROFILE_EVENTS-1)];
+        pthread_mutex_unlock(&th->lock);
+        counts[t] = (int)n;
+        for(int i = 0; i < counts[t] && ok; i++){
+            if(events[t][i].zone != PZ_FRAME) continue;
+            if(frameCount == frameCap){
+                int cap = frameCap ? frameCap*2 : 256;
+                double* grown = MemRealloc(MEM_PROFILER, frameStarts, (size_t)cap * sizeof(double));
+                if(!grown){ ok = false; break; }
+                frameStarts = grown; frameCap = cap;
+            }
+            frameStarts[frameCount++] = events[t][i].start;
+        }
+    }
+    if(!ok){
+        AddLog("Error: out of memory writing the profile");
+        for(int t = 0; t < threadCount; t++) MemFree(events[t]);
+        MemFree(frameStarts);
+        return false;
+    }
+
+    // Frame zones are recorded as they end, so sort their starts to find the Nth newest
+    double cutoff = -1e300;
+    if(frameCount > 0){
+        qsort(frameStarts, frameCount, sizeof(double), CompareDoubles);
+        cutoff = frameStarts[frameCount > frames ? frameCount - frames : 0];
+    }
+    double base = 1e300;
+    for(int t = 0; t < threadCount; t++)
+        for(int i = 0; i < counts[t]; i++) if(events[t][i].start + events[t][i].duration >= cutoff && events[t][i].start < base) base = events[t][i].start;
+
+    FILE* f = fopen(path, "w");
+    if(f){
+        int written = 0;
+        fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        for(int t = 0; t < threadCount; t++)
+            fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", t ? "," : "", t, threads[t]->name);
+        for(int t = 0; t < threadCount; t++){
+            for(int i = 0; i < counts[t]; i++){
+                const ProfileEvent* e = &events[t][i];
+                if(e->start + e->duration < cutoff) continue;
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        profileZones[e->zone].name, t, (e->start - base) * 1e6, e->duration * 1e6);
+                written++;
+            }
+        }
+        fprintf(f, "\n]}\n");
+        ok = fclose(f) == 0;
+        if(ok) AddLog("Wrote %d profile events over %d frames to '%s'", written, frameCount < frames ? frameCount : frames, path);
+    } else ok = false;
+    if(!ok) AddLog("Error: cannot write '%s'", path);
+    for(int t = 0; t < threadCount; t++) MemFree(events[t]);
+    MemFree(frameStarts);
+    return ok;
+}
+
+// --- Command execution ---
+static void ExecuteCommand(const char* cmd){
+    PROFILE_SCOPE(PZ_COMMAND);
+    char word[32]={0}; if(sscanf(cmd,"%31s",word)!=1){AddLog("Empty command"); return;}
+    if(onSimulationThread && IsUiCommand(word)){ QueueUiCommand(cmd); return; }
+    if(strcmp(word,"addCircle")==0){
+        char name[NAME_LEN]; int x,y; float size; int r,g,b;
+        if(sscanf(cmd,"addCircle %31s %d %d %f %d %d %d",name,&x,&y,&size,&r,&g,&b)==7)
+            AddObject(name,SHAPE_CIRCLE,(Vector2){x,y},size,(Color){r,g,b,255});
+        else AddLog("Usage: addCircle name x y size r g b");
+    }
+    else if(strcmp(word,"addRect")==0){
+        char name[NAME_LEN]; int x,y; float size; int r,g,b;
+        if(sscanf(cmd,"addRect %31s %d %d %f %d %d %d",name,&x,&y,&size,&r,&g,&b)==7)
+            AddObject(name,SHAPE_RECT,(Vector2){x,y},size,(Color){r,g,b,255});
+        else AddLog("Usage: addRect name x y size r g b");
+    }
+    else if(strcmp(word,"move")==0){
+        char name[NAME_LEN]; float dx,dy;
+        if(sscanf(cmd,"move %31s %f %f",name,&dx,&dy)==3){
+            int o=ResolveObject(name);
+            if(o>=0){ SetObjectPosition(o,Vector2Add(objects.position[o],(Vector2){dx,dy})); AddLog("Moved '%s'",objects.name[o]);}
+            else AddLog("Error: '%s' not found",name);
+        } else AddLog("Usage: move name dx dy");
+    }
+    else if(strcmp(word,"color")==0){
+        char name[NAME_LEN]; int r,g,b;
+        if(sscanf(cmd,"color %31s %d %d %d",name,&r,&g,&b)==4){
+            int o=ResolveObject(name);
+            if(o>=0){ SetObjectColor(o,(Color){r,g,b,255}); AddLog("Recolored '%s'",objects.name[o]);}
+            else AddLog("Error: '%s' not found",name);
+        } else AddLog("Usage: color name r g b");
+    }
+    else if(strcmp(word,"velocity")==0 || strcmp(word,"accel")==0){
+        char name[NAME_LEN]; float x,y;
+        if(sscanf(cmd,"%*s %31s %f %f",name,&x,&y)==3){
+            int o=ResolveObject(name);
+            if(o<0) AddLog("Error: '%s' not found",name);
+            else if(word[0]=='v'){ SetObjectVelocity(o,(Vector2){x,y}); AddLog("Velocity of '%s' set",objects.name[o]); }
+            else { SetObjectAcceleration(o,(Vector2){x,y}); AddLog("Acceleration of '%s' set",objects.name[o]); }
+        } else AddLog("Usage: %s name x y",word);
+    }
+    else if(strcmp(word,"damping")==0){
+        char name[NAME_LEN]; float d;
+        if(sscanf(cmd,"damping %31s %f",name,&d)==2){
+            int o=ResolveObject(name);
+            if(o>=0){ SetObjectDamping(o,d); AddLog("Damping of '%s' set",objects.name[o]); }
+            else AddLog("Error: '%s' not found",name);
+        } else AddLog("Usage: damping name d");
+    }
+    else if(strcmp(word,"update")==0){
+        char name[NAME_LEN]; if(sscanf(cmd,"update %31s",name)==1) UpdateProject(name);
+        else AddLog("Usage: update ProjectName");
+    }
+    else if(strcmp(word,"open")==0){
+        char name[NAME_LEN]; if(sscanf(cmd,"open %31s",name)==1) OpenProject(name);
+        else AddLog("Usage: open ProjectName");
+    }
+    else if(strcmp(word,"export")==0){
+        char file[NAME_LEN] = "main.game";
+        sscanf(cmd,"export %31s",file);
+        char path[256]; snprintf(path,sizeof(path),"./Projects/%s/%s",currentProject,file);
+        if(ExportSceneText(path)) AddLog("Exported %d objects to '%s'", objects.count, path);
+    }
+    else if(strcmp(word,"OpenScript")==0){
+        char scriptName[NAME_LEN];
+        if(sscanf(cmd,"OpenScript %31s",scriptName)==1) OpenScriptTab(scriptName);
+        else AddLog("Usage: OpenScript <script>");
+    }
+    else if(strcmp(word,"NewScript")==0){
+        char scriptName[NAME_LEN];
+        if(sscanf(cmd,"NewScript %31s",scriptName)==1) {
+            // Add .script extension if not present
+            char fullName[NAME_LEN];
+            if(strstr(scriptName, ".script") == NULL) {
+                snprintf(fullName, sizeof(fullName), "%s.script", scriptName);
+            } else {
+                strncpy(fullName, scriptName, NAME_LEN-1);
+            }
+            OpenScriptTab(fullName);
+        } else AddLog("Usage: NewScript <name>");
+    }
+    else if(strcmp(word,"NewPython")==0){
+        char scriptName[NAME_LEN];
+        if(sscanf(cmd,"NewPython %31s",scriptName)==1) {
+            char fullName[NAME_LEN];
+            if(strstr(scriptName, ".py") == NULL) {
+                snprintf(fullName, sizeof(fullName), "%s.py", scriptName);
+            } else {
+                strncpy(fullName, scriptName, NAME_LEN-1);
+            }
+            OpenScriptTab(fullName);
+        } else AddLog("Usage: NewPython <name>");
+    }
+    else if(strcmp(word,"RunScript")==0){
+        char scriptName[NAME_LEN];
+        if(sscanf(cmd,"RunScript %31s",scriptName)==1) ExecuteScript(scriptName);
+        else AddLog("Usage: RunScript <script>");
+    }
+    else if(strcmp(word,"RunPython")==0){
+        char scriptName[NAME_LEN];
+        if(sscanf(cmd,"RunPython %31s",scriptName)==1) ExecutePythonScript(scriptName);
+        else AddLog("Usage: RunPython <script.py>");
+    }
+    else if(strcmp(word,"StopPython")==0){
+        char scriptName[NAME_LEN];
+        if(sscanf(cmd,"StopPython %31s",scriptName)==1){
+            RemovePythonHooks(currentProject, scriptName);
+            AddLog("Stopped Python hooks of '%s'", scriptName);
+        }
+        else AddLog("Usage: StopPython <script.py>");
+    }
+    else if(strcmp(word,"set")==0){
+        char varName[NAME_LEN]; int valueStart = 0;
+        if(sscanf(cmd,"set %31s %n",varName,&valueStart)==1 && cmd[valueStart]) {
+            char base[NAME_LEN], type[8] = {0}, parts[4][64];
+            int component = ParseVariableRef(varName, base);
+            int slot = InternVariable(base);
+            int typeEnd = 0;
+            const char* rest = cmd + valueStart;
+            sscanf(rest, "%7s %n", type, &typeEnd);
+            if(slot < 0) AddLog("Error: cannot create variable '%s'", base);
+            else if(typeEnd > 0 && rest[typeEnd] && (strcmp(type,"int")==0 || strcmp(type,"float")==0)) {
+                float value = EvaluateExpression(rest + typeEnd);
+                variables[slot].type = (strcmp(type,"int")==0) ? VAR_INT : VAR_FLOAT;
+                SetVariableValue(slot, 0, value);
+                char text[96]; FormatVariable(&variables[slot], text, sizeof(text));
+                AddLog("Set %s", text);
+            }
+            else if(typeEnd > 0 && strcmp(type,"vec2")==0 && sscanf(rest + typeEnd, "%63s %63s", parts[0], parts[1]) == 2) {
+                Variable* v = &variables[slot];
+                v->type = VAR_VEC2; v->defined = true;
+                v->value.v = (Vector2){ EvaluateExpression(parts[0]), EvaluateExpression(parts[1]) };
+                JournalVariableChanged(slot);
+                char text[96]; FormatVariable(v, text, sizeof(text));
+                AddLog("Set %s", text);
+            }
+            else if(typeEnd > 0 && strcmp(type,"color")==0) {
+                int n = sscanf(rest + typeEnd, "%63s %63s %63s %63s", parts[0], parts[1], parts[2], parts[3]);
+                if(n >= 3) {
+                    Variable* v = &variables[slot];
+                    v->type = VAR_COLOR; v->defined = true;
+                    v->value.c = (Color){ (unsigned char)Clamp(EvaluateExpression(parts[0]),0,255), (unsigned char)Clamp(EvaluateExpression(parts[1]),0,255),
+                                          (unsigned char)Clamp(EvaluateExpression(parts[2]),0,255), (unsigned char)(n == 4 ? Clamp(EvaluateExpression(parts[3]),0,255) : 255) };
+                    JournalVariableChanged(slot);
+                    char text[96]; FormatVariable(v, text, sizeof(text));
+                    AddLog("Set %s", text);
+                } else AddLog("Usage: set varName color r g b [a]");
+            }
+            else {
+                float value = EvaluateExpression(rest);
+                SetVariableValue(slot, component, value);
+                AddLog("Set %s = %.2f", varName, value);
+            }
+        } else AddLog("Usage: set varName [int|float|vec2|color] value...");
+    }
+    else if(strcmp(word,"labels")==0){
+        char arg[32];
+        if(sscanf(cmd,"labels %31s",arg)!=1) AddLog("Usage: labels on|off|<min size>");
+        else if(strcmp(arg,"on")==0){ labelsVisible=true; labelMinSize=0; AddLog("Labels on"); }
+        else if(strcmp(arg,"off")==0){ labelsVisible=false; AddLog("Labels off"); }
+        else { labelsVisible=true; labelMinSize=(float)atof(arg); AddLog("Labels for objects of size >= %.0f", labelMinSize); }
+    }
+    else if(strcmp(word,"collisions")==0){
+        char arg[32];
+        if(sscanf(cmd,"collisions %31s",arg)!=1)
+            AddLog("Collisions %s: %d pairs, %d events, last pass %.2f ms", collision.enabled ? "on" : "off",
+                   collision.pairCount, collision.eventCount, collision.passTime*1000.0);
+        else if(strcmp(arg,"on")==0){ EnableCollisions(); AddLog("Collisions on"); }
+        else if(strcmp(arg,"off")==0){ DisableCollisions(); AddLog("Collisions off"); }
+        else AddLog("Usage: collisions [on|off]");
+    }
+    else if(strcmp(word,"stats")==0){
+        AddLog("Render: %d shapes, %d labels, %d vertices, %d draw calls",
+               renderStats.shapes, renderStats.labels, renderStats.vertices, renderStats.drawCalls);
+    }
+    else if(strcmp(word,"mem")==0){
+        long long blocks = 0;
+        for(int t = 0; t < MEM_COUNT; t++) blocks += atomic_load_explicit(&memBlocks[t], memory_order_relaxed);
+        char total[32]; FormatBytes(MemTotal(), total, sizeof(total));
+        AddLog("Memory: %s in %lld blocks (engine allocations only)", total, blocks);
+        for(int t = 0; t < MEM_COUNT; t++){
+            long long bytes = atomic_load_explicit(&memBytes[t], memory_order_relaxed);
+            long long arena = atomic_load_explicit(&memArenaUsed[t], memory_order_relaxed);
+            if(bytes == 0) continue;
+            char size[32], used[32]; FormatBytes(bytes, size, sizeof(size)); FormatBytes(arena, used, sizeof(used));
+            if(arena > 0) AddLog("  %-12s %10s in %lld blocks, %s used by arenas", memTagNames[t], size, atomic_load_explicit(&memBlocks[t], memory_order_relaxed), used);
+            else AddLog("  %-12s %10s in %lld blocks", memTagNames[t], size, atomic_load_explicit(&memBlocks[t], memory_order_relaxed));
+        }
+    }
+    else if(strcmp(word,"profile")==0){
+        char arg[32] = {0}, file[NAME_LEN] = "profile.json"; int frames = PROFILE_DUMP_FRAMES;
+        sscanf(cmd,"profile %31s",arg);
+        if(!arg[0]){ profileOverlay = !profileOverlay; AddLog("Profiler overlay %s", profileOverlay ? "on" : "off"); }
+        else if(strcmp(arg,"on")==0){ profileOverlay = true; AddLog("Profiler overlay on"); }
+        else if(strcmp(arg,"off")==0){ profileOverlay = false; AddLog("Profiler overlay off"); }
+        else if(strcmp(arg,"dump")==0){
+            char first[NAME_LEN] = {0};
+            int n = sscanf(cmd,"profile dump %31s %31s",first,file);
+            if(n >= 1 && !(isdigit((unsigned char)first[0]) && (frames = atoi(first)) > 0)){ frames = PROFILE_DUMP_FRAMES; snprintf(file, sizeof(file), "%s", first); }
+            char path[256]; snprintf(path,sizeof(path),"./Projects/%s/%s",currentProject,file);
+            WriteProfileTrace(path, frames);
+        }
+        else AddLog("Usage: profile [on|off|dump [frames] [file]]");
+    }
+    else if(strcmp(word,"delete")==0){
+        char name[NAME_LEN];
+        if(sscanf(cmd,"delete %31s",name)==1) {
+            DeleteObject(name);
+        } else {
+            AddLog("Usage: delete objectName");
+        }
+    }
+    else AddLog("Unknown command: %s",word);
+}
+
+// --- Mouse/Object utilities ---
+static void ClearSelection(void){memset(objects.selected,0,(size_t)objects.count*sizeof(bool));}
+
+// Simple syntax highlighting for our scripting language
+static Color GetScriptTokenColor(const char* token) {
+    // Keywords
+    const char* keywords[] = {"move", "setPos", "setColor", "createCircle", "createRect", 
+                             "setVel", "setAccel", "setDamping", "log", "for", "if", "while", "end"};
+    int keywordCount = sizeof(keywords) / sizeof(keywords[0]);
+    
+    for(int i = 0; i < keywordCount; i++) {
+        if(strcmp(token, keywords[i]) == 0) {
+            return ACCENT_BLUE;
+        }
+    }
+    
+    // Numbers
+    if(isdigit(token[0]) || (token[0] == '-' && isdigit(token[1]))) {
+        return ACCENT_ORANGE;
+    }
+    
+    // Strings
+    if(token[0] == '"') {
+        return ACCENT_GREEN;
+    }
+    
+    // Variables (common names)
+    if(strcmp(token, "x") == 0 || strcmp(token, "y") == 0 || 
+       strcmp(token, "i") == 0 || strcmp(token, "angle") == 0) {
+        return ACCENT_PURPLE;
+    }
+    
+    return TEXT_PRIMARY;
+}
+
+// Add Python syntax highlighting
+static Color GetPythonTokenColor(const char* token) {
+    // Python keywords - expanded list
+    const char* keywords[] = {
+        "and", "assert", "break", "class", "continue", "def",
+        "del", "elif", "else", "except", "exec", "finally",
+        "for", "from", "global", "if", "import", "in",
+        "is", "lambda", "not", "or", "pass", "print",
+        "raise", "return", "try", "while", "yield",
+        "None", "True", "False"
+    };
+    int keywordCount = sizeof(keywords) / sizeof(keywords[0]);
+    
+    for(int i = 0; i < keywordCount; i++) {
+        if(strcmp(token, keywords[i]) == 0) {
+            return ACCENT_BLUE;
+        }
+    }
+    
+    // Python built-in functions
+    const char* builtins[] = {"len", "range", "str", "int", "float", "list", "dict", "open", "abs", "min", "max"};
+    int builtinCount = sizeof(builtins) / sizeof(builtins[0]);
+    
+    for(int i = 0; i < builtinCount; i++) {
+        if(strcmp(token, builtins[i]) == 0) {
+            return ACCENT_PURPLE;
+        }
+    }
+    
+    // Game API functions: everything the native module exports
+    for(const PyMethodDef* m = GameMethods; m->ml_name; m++) {
+        if(strcmp(token, m->ml_name) == 0) {
+            return ACCENT_GREEN;
+        }
+    }
+    
+    // Numbers
+    if(isdigit(token[0]) || (token[0] == '-' && isdigit(token[1]))) {
+        return ACCENT_ORANGE;
+    }
+    
+    // Strings
+    if(token[0] == '"' || token[0] == '\'') {
+        return ACCENT_GREEN;
+    }
+    
+    return TEXT_PRIMARY;
+}
+
+// --- Editor syntax highlighting ---
+#define EDITOR_FONT_SIZE 14
+
+static bool IsPythonOperator(char c){ return c && strchr("=<>!+-*/%&|^~", c) != NULL; }
+static bool IsScriptOperator(char c){ return c=='=' || c=='+' || c=='-' || c=='*' || c=='/'; }
+
+static void AddSpan(LineLayout* L, int start, int len, Color color){
+    if(len <= 0) return;
+    TokenSpan* last = L->spanCount ? &L->spans[L->spanCount-1] : NULL;
+    if(last && last->start + last->len == start && memcmp(&last->color, &color, sizeof(Color)) == 0){ last->len += len; return; }
+    if(L->spanCount == L->spanCapacity){
+        int cap = L->spanCapacity ? L->spanCapacity*2 : 16;
+        TokenSpan* spans = ArenaGrow(L->arena, L->spans, (size_t)L->spanCapacity * sizeof(TokenSpan), (size_t)cap * sizeof(TokenSpan));
+        if(!spans) return;
+        L->spans = spans;
+        L->spanCapacity = cap;
+    }
+    L->spans[L->spanCount++] = (TokenSpan){ start, len, color };
+}
+
+// Copies an identifier for keyword lookup; longer ones are never keywords
+static const char* TokenWord(const char* line, int start, int end, char* word, int size){
+    if(end - start >= size) return "";
+    memcpy(word, line + start, end - start);
+    word[end - start] = '\0';
+    return word;
+}
+
+static void TokenizePython(const char* line, LineLayout* L){
+    int n = (int)strlen(line);
+    for(int c = 0; c < n;){
+        int start = c;
+        char ch = line[c];
+        if(ch == '#'){ AddSpan(L, c, n-c, TEXT_SECONDARY); break; }
+        if(ch == '"' || ch == '\''){
+            for(c++; c < n && line[c] != ch; c++) if(line[c] == '\\' && c+1 < n) c++;
+            if(c < n) c++;
+            AddSpan(L, start, c-start, ACCENT_GREEN);
+        } else if(isalpha((unsigned char)ch) || ch == '_'){
+            char word[NAME_LEN];
+            while(c < n && (isalnum((unsigned char)line[c]) || line[c] == '_')) c++;
+            AddSpan(L, start, c-start, GetPythonTokenColor(TokenWord(line, start, c, word, sizeof(word))));
+        } else if(isdigit((unsigned char)ch) || (ch == '.' && isdigit((unsigned char)line[c+1]))){
+            while(c < n && (isalnum((unsigned char)line[c]) || line[c] == '.')) c++;
+            AddSpan(L, start, c-start, ACCENT_ORANGE);
+        } else if(IsPythonOperator(ch)){
+            while(c < n && IsPythonOperator(line[c])) c++;
+            AddSpan(L, start, c-start, ACCENT_GREEN);
+        } else {
+            c++;
+            AddSpan(L, start, 1, TEXT_PRIMARY);
+        }
+    }
+}
+
+static void TokenizeScript(const char* line, LineLayout* L){
+    int n = (int)strlen(line);
+    for(int c = 0; c < n;){
+        int start = c;
+        if(isalnum((unsigned char)line[c]) || line[c] == '_'){
+            char word[NAME_LEN];
+            while(c < n && (isalnum((unsigned char)line[c]) || line[c] == '_')) c++;
+            AddSpan(L, start, c-start, GetScriptTokenColor(TokenWord(line, start, c, word, sizeof(word))));
+        } else {
+            char ch = line[c++];
+            AddSpan(L, start, 1, IsScriptOperator(ch) ? ACCENT_ORANGE : ch == '"' ? ACCENT_GREEN : TEXT_PRIMARY);
+        }
+    }
+}
+
+// Same per-glyph sum MeasureTextEx does, kept for every prefix of the line
+static void MeasureLineAdvances(Font font, const char* line, float* advance){
+    float scale = (float)EDITOR_FONT_SIZE / font.baseSize;
+    advance[0] = 0;
+    for(int c = 0; line[c]; c++){
+        int g = GetGlyphIndex(font, (unsigned char)line[c]);
+        float w = font.glyphs[g].advanceX ? (float)font.glyphs[g].advanceX : font.recs[g].width + font.glyphs[g].offsetX;
+        advance[c+1] = advance[c] + w*scale;
+    }
+}
+
+// Layout of line i, re-tokenized only if it was edited or the font changed
+static const LineLayout* EditorLineLayout(ScriptEditor* ed, int i, Font font){
+    static const LineLayout empty = {0};
+    TextLine* line = TextLineAt(ed->text, i);
+    if(!line->layout){
+        if(!(line->layout = ArenaAlloc(&ed->text->layout, sizeof(LineLayout)))) return &empty;
+        memset(line->layout, 0, sizeof(LineLayout));
+        line->layout->arena = &ed->text->layout;
+    }
+    LineLayout* L = line->layout;
+    if(L->valid && L->fontEpoch == fontEpoch) return L;
+    if(line->len + 1 > L->advanceCapacity){
+        int cap = L->advanceCapacity > 16 ? L->advanceCapacity : 16;
+        while(cap < line->len + 1) cap *= 2;
+        float* advance = ArenaGrow(L->arena, L->advance, (size_t)L->advanceCapacity * sizeof(float), (size_t)cap * sizeof(float));
+        if(!advance) return &empty;
+        L->advance = advance;
+        L->advanceCapacity = cap;
+    }
+    const char* text = TextLineStr(ed->text, i);
+    L->spanCount = 0;
+    if(ed->isPython) TokenizePython(text, L);
+    else if(ed->isScript) TokenizeScript(text, L);
+    else AddSpan(L, 0, line->len, TEXT_PRIMARY);
+    MeasureLineAdvances(font, text, L->advance);
+    L->valid = true;
+    L->fontEpoch = fontEpoch;
+    return L;
+}
+
+static void DrawEditorLine(ScriptEditor* ed, int i, Font font, Vector2 origin){
+    const LineLayout* L = EditorLineLayout(ed, i, font);
+    TextLine* line = TextLineAt(ed->text, i);
+    for(int k = 0; k < L->spanCount; k++){
+        const TokenSpan* t = &L->spans[k];
+        // Terminate the span in place for DrawTextEx
+        char* end = line->text + t->start + t->len;
+        char saved = *end; *end = '\0';
+        DrawTextEx(font, line->text + t->start, (Vector2){origin.x + L->advance[t->start], origin.y}, EDITOR_FONT_SIZE, 0, t->color);
+        *end = saved;
+    }
+}
+
+// --- Startup scene ---
+static void InitScene(void){
+    bool hasScene = LoadProjectScene(currentProject);
+    if(!hasScene){
+        AddObject("player",SHAPE_CIRCLE,(Vector2){500,300},40,ACCENT_RED);
+        AddObject("box",SHAPE_RECT,(Vector2){700,350},50,ACCENT_BLUE);
+    }
+
+    char scriptsDir[256]; snprintf(scriptsDir,sizeof(scriptsDir),"./Projects/%s",currentProject);
+    CreateDirIfNotExist("./Projects"); CreateDirIfNotExist(scriptsDir);
+    SetLogProject(currentProject);
+    strncat(scriptsDir, "/scripts", sizeof(scriptsDir)-strlen(scriptsDir)-1);
+    CreateDirIfNotExist(scriptsDir);
+    LoadScripts(currentProject);
+
+    // Initialize some example variables (a saved scene brings its own)
+    if(!hasScene){
+        SetVariable("speed", 5.0f);
+        SetVariable("angle", 0.0f);
+    }
+}
+
+// --- Headless benchmark ---
+typedef struct {
+    int ticks;
+    const char* project;
+    const char* pythonScript; // Run through ExecutePythonScript every tick
+    const char* loadScript;   // Run once before the first tick (registers hooks)
+    bool render;              // Also cull and tessellate the canvas each tick (no GL submit)
+    bool verbose;
+    int threads;              // Job system threads including the main one; 0 = every core
+} HeadlessOptions;
+
+static void PrintPhase(const char* label, double total, int ticks){
+    printf("  %-10s %10.3f ms total %10.3f us/tick\n", label, total*1000.0, ticks>0 ? total*1e6/ticks : 0.0);
+}
+
+// Runs the same per-tick work as the Run button without opening a window
+static int RunHeadless(const HeadlessOptions* opts){
+    echoLogs = opts->verbose;
+    if(opts->project){ strncpy(currentProject, opts->project, NAME_LEN-1); currentProject[NAME_LEN-1] = '\0'; }
+
+    double setupStart = NowSeconds();
+    ProfileRegisterThread("main");
+    StartLogWriter();
+    StartJobSystem(opts->threads);
+    if(!InitializePython()) AddLog("Warning: Python initialization failed");
+    InitScene();
+    WaitForScripts();
+    if(opts->loadScript) ExecutePythonScript(opts->loadScript);
+    double setupTime = NowSeconds() - setupStart;
+
+    printf("Headless run: project '%s', %d ticks @ %d Hz, %d scripts, %d objects, %d threads\n",
+           currentProject, opts->ticks, SIM_TICK_RATE, scriptCount, objects.count, jobWorkerCount+1);
+
+    TickTimings timings = {0};
+    double pythonScriptTime = 0, renderTime = 0;
+    Rectangle canvas = HEADLESS_CANVAS;
+    running = true;
+    double start = NowSeconds();
+    for(int t = 0; t < opts->ticks; t++){
+        ProfileBegin(PZ_FRAME);
+        ApplyScriptUpdates();
+        if(opts->pythonScript){
+            double p0 = NowSeconds();
+            ExecutePythonScript(opts->pythonScript);
+            pythonScriptTime += NowSeconds() - p0;
+        }
+        SimulationTick(&timings);
+        JournalPoll();
+        if(opts->render){
+            double r0 = NowSeconds();
+            renderStats = (RenderStats){0};
+            BuildSceneFrame(frontFrame, canvas, false);
+            ProfileBegin(PZ_DRAW_CANVAS);
+            BuildShapeBatch(frontFrame, 1);
+            FlushBatch(&shapeBatch, false);
+            ProfileEnd();
+            renderTime += NowSeconds() - r0;
+        }
+        ProfileEnd();
+    }
+    double total = NowSeconds() - start;
+    running = false;
+
+    printf("  %-10s %10.3f ms\n", "setup", setupTime*1000.0);
+    PrintPhase("scripts", timings.scripts, opts->ticks);
+    PrintPhase("variables", timings.variables, opts->ticks);
+    PrintPhase("python", timings.python + pythonScriptTime, opts->ticks);
+    if(integrateKernel) PrintPhase(integrateKernel == IntegrateScalar ? "motion" : integrateKernelName, timings.motion, opts->ticks);
+    if(collision.enabled){
+        PrintPhase("collisions", timings.collisions, opts->ticks);
+        printf("  %-10s %10d pairs, %d events (last tick)\n", "contacts", collision.pairCount, collision.eventCount);
+    }
+    if(opts->render){
+        PrintPhase("render", renderTime, opts->ticks);
+        printf("  %-10s %10d shapes, %d vertices, %d draw calls (last tick)\n", "batch",
+               renderStats.shapes, renderStats.vertices, renderStats.drawCalls);
+    }
+    PrintPhase("tick", total, opts->ticks);
+    printf("  ticks/sec  %10.1f (simulated %.2f s in %.3f s)\n",
+           total > 0 ? opts->ticks/total : 0.0, (double)opts->ticks/SIM_TICK_RATE, total);
+    printf("  objects    %10d\n", objects.count);
+    char memory[32]; FormatBytes(MemTotal(), memory, sizeof(memory));
+    printf("  memory     %10s allocated by the engine\n", memory);
+
+    if(Py_IsInitialized()){ ClearPythonHooks(); Py_Finalize(); }
+    JournalClose();
+    StopScriptLoader();
+    StopJobSystem();
+    StopLogWriter();
+    return 0;
+}
+
+static void PrintUsage(const char* exe){
+    printf("Usage: %s [--headless] [--ticks N] [--project NAME] [--python SCRIPT.py] [--load SCRIPT.py] [--render] [--threads N] [--verbose]\n", exe);
+}
+
+// --- Main ---
+int main(int argc, char** argv){
+    HeadlessOptions opts = { HEADLESS_DEFAULT_TICKS, NULL, NULL, NULL, false, false, 0 };
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--headless") == 0) headless = true;
+        else if(strcmp(argv[i], "--ticks") == 0 && i+1 < argc) opts.ticks = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--project") == 0 && i+1 < argc) opts.project = argv[++i];
+        else if(strcmp(argv[i], "--python") == 0 && i+1 < argc) opts.pythonScript = argv[++i];
+        else if(strcmp(argv[i], "--load") == 0 && i+1 < argc) opts.loadScript = argv[++i];
+        else if(strcmp(argv[i], "--verbose") == 0) opts.verbose = true;
+        else if(strcmp(argv[i], "--render") == 0) opts.render = true;
+        else if(strcmp(argv[i], "--threads") == 0 && i+1 < argc) opts.threads = atoi(argv[++i]);
+        else { PrintUsage(argv[0]); return (strcmp(argv[i], "--help") == 0) ? 0 : 1; }
+    }
+    if(headless) return RunHeadless(&opts);
+
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+    InitWindow(1200,800,"2D Game Engine with Python Integration");
+    SetTargetFPS(60);
+    ProfileRegisterThread("main");
+    StartLogWriter();
+    StartJobSystem(0);
+    // Load custom font
+    Font customFont = LoadFont("C:/Fonts/Codey/static/SourceCodePro-Bold.ttf");
+    if (customFont.texture.id == 0) {
+        // Fallback to default if font fails to load
+        customFont = GetFontDefault();
+        AddLog("Failed to load custom font, using default");
+    } else {
+        AddLog("Custom font loaded successfully");
+    }
+
+    // Initialize Python
+    if(!InitializePython()) {
+        AddLog("Warning: Python initialization failed");
+    }
+
+    InitScene();
+
+    // The simulation thread takes the GIL per tick; the main thread asks for it when it runs Python
+    PyThreadState* mainThreadState = Py_IsInitialized() ? PyEval_SaveThread() : NULL;
+    labelFont = customFont;
+    StartSimulationThread();
+
+    Rectangle playButton={(float)GetScreenWidth()-120,10,100,40};
+
+    int editorCharY = 18;
+
+    while(!WindowShouldClose()){
+        ProfileBegin(PZ_FRAME);
+        ProfileBegin(PZ_LOCK_WAIT);
+        pthread_mutex_lock(&worldLock); // Input and commands change the live state
+        ProfileEnd();
+        ApplyScriptUpdates(); // Scripts the loader read since the last frame
+        const int screenW = GetScreenWidth();
+        const int screenH = GetScreenHeight();
+        const int commandBarH=40;
+        const int logBarH=80;
+        const int tabBarH=35;
+        const int leftPanelW=220;
+        const int bottomH=commandBarH+logBarH;
+
+        Vector2 mouse=GetMousePosition();
+
+        // --- Input handling ---
+        ProfileBegin(PZ_INPUT);
+        if(IsKeyPressed(KEY_F3)) profileOverlay = !profileOverlay;
+        int ch = GetCharPressed();
+        while(ch > 0) {
+            if(activeEditor >= 0 && !visualEditorOpen) {
+                // Script editor input
+                ScriptEditor *ed = &openEditors[activeEditor];
+                if(caretLine >= TextLineCount(ed->text)) caretLine = TextLineCount(ed->text) - 1;
+                if(caretLine < 0) caretLine = 0;
+                caretCol = Clamp(caretCol, 0, TextLineLength(ed->text, caretLine));
+                
+                if(ch >= 32 && ch <= 125){
+                    TextLineInsertChar(ed->text, caretLine, caretCol, (char)ch);
+                    ed->modified = true;
+                    caretCol++;
+                    if(caretLine >= ed->scroll + VISIBLE_LINES) ed->scroll++;
+                }
+            } else {
+                // Visual editor or no editor - input goes to command bar
+                if(ch >= 32 && ch <= 125 && commandLen < CMD_LEN-1){
+                    commandBuffer[commandLen++] = (char)ch;
+                    commandBuffer[commandLen] = '\0';
+                }
+            }
+            ch = GetCharPressed();
+        }
+
+        // --- Backspace / Enter ---
+        if(activeEditor >= 0 && !visualEditorOpen){
+            ScriptEditor *ed = &openEditors[activeEditor];
+            if(IsKeyPressed(KEY_BACKSPACE) && caretCol>0){
+                TextLineEraseChar(ed->text, caretLine, caretCol-1);
+                ed->modified = true;
+                caretCol--;
+            } else if(IsKeyPressed(KEY_BACKSPACE) && caretLine>0){
+                // Join with the previous line
+                int prevLen = TextLineLength(ed->text, caretLine-1);
+                TextLineInsert(ed->text, caretLine-1, prevLen, TextLineStr(ed->text, caretLine), TextLineLength(ed->text, caretLine));
+                TextBufferDeleteLine(ed->text, caretLine);
+                ed->modified = true;
+                caretLine--; caretCol=prevLen;
+                if(caretLine<ed->scroll) ed->scroll--;
+            }
+            if(IsKeyPressed(KEY_ENTER)){
+                if(TextBufferInsertLine(ed->text, caretLine+1, "", 0)){
+                    ed->modified = true;
+                    caretLine++; caretCol=0;
+                    if(caretLine >= ed->scroll + VISIBLE_LINES) ed->scroll++;
+                }
+            }
+            // Arrow keys
+            if(IsKeyPressed(KEY_UP)){ if(caretLine>0) caretLine--; caretCol=Clamp(caretCol,0,TextLineLength(ed->text,caretLine)); if(caretLine<ed->scroll) ed->scroll--; }
+            if(IsKeyPressed(KEY_DOWN)){ if(caretLine<TextLineCount(ed->text)-1) caretLine++; caretCol=Clamp(caretCol,0,TextLineLength(ed->text,caretLine)); if(caretLine>=ed->scroll+VISIBLE_LINES) ed->scroll++; }
+            if(IsKeyPressed(KEY_LEFT) && caretCol>0) caretCol--;
+            if(IsKeyPressed(KEY_RIGHT) && caretCol<TextLineLength(ed->text,caretLine)) caretCol++;
+            
+            // Ctrl+S to save
+            if(IsKeyDown(KEY_LEFT_CONTROL) && IsKeyPressed(KEY_S)) SaveScript(ed);
+            
+            // F5 to run script
+            if(IsKeyPressed(KEY_F5)) {
+                SaveScript(ed);
+                // Commands the script runs may open tabs and move openEditors
+                char name[NAME_LEN]; memcpy(name, ed->name, NAME_LEN);
+                if(ed->isPython) {
+                    ExecutePythonScript(name);
+                } else if(ed->isScript) {
+                    ExecuteScript(name);
+                }
+            }
+        } else {
+            // Visual editor or command bar input
+            if(IsKeyPressed(KEY_BACKSPACE) && commandLen>0){ commandLen--; commandBuffer[commandLen]='\0'; }
+            if(IsKeyPressed(KEY_ENTER) && commandLen>0){ ExecuteCommand(commandBuffer); commandLen=0; commandBuffer[0]='\0'; }
+        }
+
+        if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON)){
+            int totalTabs = openCount + 1;
+            float tabW = (float)screenW / totalTabs;
+            
+            // Check visual editor tab
+            Rectangle visualTab = {0, 0, tabW, tabBarH};
+            if(CheckCollisionPointRec(mouse, visualTab)){
+                visualEditorOpen = true;
+                activeEditor = -1;
+            } else {
+                // Check script editor tabs
+                for(int i=0;i<openCount;i++){
+                    Rectangle tab={(i+1)*tabW,0,tabW,tabBarH};
+                    if(CheckCollisionPointRec(mouse, tab)){
+                        activeEditor = i;
+                        visualEditorOpen = false;
+                        caretLine = 0;
+                        caretCol = 0;
+                        break;
+                    }
+                }
+            }
+        }
+
+        ProfileEnd();
+
+        // --- Auto-suggest ---
+        ProfileBegin(PZ_SUGGEST);
+        suggestionCount=0; highlightedSuggestion=-1;
+        if(strncmp(commandBuffer,"OpenScript ",11)==0){
+            const char* partial = commandBuffer+11;
+            for(int i=0;i<scriptCount;i++){
+                if(strncmp(scripts[i].name, partial, strlen(partial))==0){
+                    strncpy(suggestions[suggestionCount], scripts[i].name, NAME_LEN-1);
+                    suggestionCount++; if(suggestionCount>=MAX_SUGGESTIONS) break;
+                }
+            }
+        }
+
+        ProfileEnd();
+
+        // --- Object dragging ---
+        ProfileBegin(PZ_DRAG);
+        Rectangle canvas = {(float)leftPanelW, tabBarH, (float)(screenW-leftPanelW), (float)(screenH-bottomH-tabBarH)};
+        if(CheckCollisionPointRec(mouse, canvas)){
+            if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON)){
+                dragging=false; int picked=-1;
+                picked=PickObject(mouse);
+                if(picked>=0){ ClearSelection(); objects.selected[picked]=true; dragOffset=Vector2Subtract(objects.position[picked],mouse); dragging=true; AddLog("Selected '%s'",objects.name[picked]);}
+                else ClearSelection();
+            }
+            if(IsMouseButtonDown(MOUSE_LEFT_BUTTON) && dragging) for(int i=0;i<objects.count;i++) if(objects.selected[i]) SetObjectPosition(i,Vector2Add(mouse,dragOffset));
+            if(IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) dragging=false;
+        } else if(IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) dragging=false;
+        ProfileEnd();
+
+        // --- Run scripts ---
+        if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mouse,playButton)) running=!running;
+        if(!simThreadRunning){
+            // No simulation thread: tick once per frame as before
+            if(running) SimulationTick(NULL);
+            BuildSceneFrame(backFrame, canvas, false);
+            PublishSceneFrame(NowSeconds());
+        }
+        JournalPoll();
+        pthread_mutex_unlock(&worldLock);
+
+        // --- Draw ---
+        // Everything below reads the newest frame, never the live state; the
+        // editor tabs are main-thread state (see RunUiCommands)
+        ProfileBegin(PZ_DRAW);
+        SceneFrame* frame = AcquireSceneFrame(canvas);
+        float alpha = frame->interpolate ? Clamp((float)((NowSeconds() - frame->time) * SIM_TICK_RATE), 0, 1) : 1;
+        BeginDrawing();
+        ClearBackground(BG_DARK);
+
+        // Calculate tab width (including visual editor tab)
+        ProfileBegin(PZ_DRAW_TABS);
+        int totalTabs = openCount + 1; // +1 for visual editor
+        float tabW = (float)screenW / totalTabs;
+
+        // Draw visual editor tab first
+        Rectangle visualTab = {0, 0, tabW, tabBarH};
+        Color visualTabColor = visualEditorOpen ? BG_LIGHT : BG_MEDIUM;
+        DrawRectangleRec(visualTab, visualTabColor);
+        if(visualEditorOpen) {
+            DrawRectangle(visualTab.x, visualTab.y + visualTab.height - 3, visualTab.width, 3, ACCENT_BLUE);
+        }
+        DrawTextEx(customFont, "Visual Editor", (Vector2){visualTab.x+10, visualTab.y+8}, 16, 0, TEXT_PRIMARY);
+
+        // Draw script editor tabs
+        for(int i=0;i<openCount;i++){
+            Rectangle tab={(i+1)*tabW,0,tabW,tabBarH}; // +1 to account for visual editor tab
+            Color tabColor = (i == activeEditor && !visualEditorOpen) ? BG_LIGHT : BG_MEDIUM;
+            DrawRectangleRec(tab, tabColor);
+            if(i == activeEditor && !visualEditorOpen) {
+                DrawRectangle(tab.x, tab.y + tab.height - 3, tab.width, 3, ACCENT_BLUE);
+            }
+            
+            // Draw script indicators and names (your existing code)
+            if(openEditors[i].isPython) {
+                DrawTextEx(customFont, "Python", (Vector2){tab.x+5, tab.y+5}, 10, 0, ACCENT_GREEN);
+                DrawTextEx(customFont, openEditors[i].name, (Vector2){tab.x+45, tab.y+8}, 16, 0, TEXT_PRIMARY);
+            } else if(openEditors[i].isScript) {
+                DrawTextEx(customFont, "Script", (Vector2){tab.x+5, tab.y+5}, 10, 0, ACCENT_PURPLE);
+                DrawTextEx(customFont, openEditors[i].name, (Vector2){tab.x+45, tab.y+8}, 16, 0, TEXT_PRIMARY);
+            } else {
+                DrawTextEx(customFont, openEditors[i].name, (Vector2){tab.x+10, tab.y+8}, 16, 0, TEXT_PRIMARY);
+            }
+            
+            if(i > 0 || true) { // Always draw separator after visual editor tab
+                DrawLine(tab.x, tab.y, tab.x, tab.y + tab.height, BG_DARK);
+            }
+        }
+
+        ProfileEnd();
+
+        // Enhanced Left panel with variables
+        ProfileBegin(PZ_DRAW_PANEL);
+        DrawRectangle(0,tabBarH,(float)leftPanelW,(float)(screenH-bottomH-tabBarH),BG_MEDIUM);
+        DrawRectangle(leftPanelW-1,tabBarH,1,(float)(screenH-bottomH-tabBarH),BG_LIGHT);
+        
+        int yOffset = tabBarH+15;
+        DrawTextEx(customFont, "Objects:", (Vector2){15, yOffset}, 18, 0, TEXT_PRIMARY);
+        yOffset += 30;
+        
+        for(int i=0;i<frame->panelCount;i++){  // Limit to 8 objects for space
+            Color objColor = frame->panelSelected[i] ? ACCENT_BLUE : TEXT_SECONDARY;
+            Rectangle objRect = {10, yOffset+i*25, leftPanelW-20, 22};
+            if(frame->panelSelected[i]) {
+                DrawRectangleRounded(objRect, 0.2f, 8, (Color){ACCENT_BLUE.r, ACCENT_BLUE.g, ACCENT_BLUE.b, 40});
+            }
+            DrawTextEx(customFont, frame->panelName[i], (Vector2){15, yOffset+5+i*25}, 16, 0, objColor);
+            
+            if(frame->panelShape[i] == SHAPE_CIRCLE) {
+                DrawCircle(leftPanelW-25, yOffset+13+i*25, 6, frame->panelColor[i]);
+            } else {
+                DrawRectangle(leftPanelW-31, yOffset+7+i*25, 12, 12, frame->panelColor[i]);
+            }
+        }
+        
+        yOffset += frame->panelCount * 25 + 20;
+        DrawTextEx(customFont, "Variables:", (Vector2){15, yOffset}, 18, 0, TEXT_PRIMARY);
+        yOffset += 25;
+        
+        for(int i=0;i<frame->variableLines;i++){  // Limit to 6 variables for space
+            DrawTextEx(customFont, frame->variableText[i], (Vector2){15, yOffset+i*18}, 14, 0, ACCENT_PURPLE);
+        }
+
+        ProfileEnd();
+
+        // Enhanced Canvas
+        ProfileBegin(PZ_DRAW_CANVAS);
+        DrawRectangleRec(canvas,BG_MEDIUM);
+        DrawRectangleLinesEx(canvas, 1, BG_LIGHT);
+        
+        renderStats = (RenderStats){0};
+        BuildShapeBatch(frame, alpha);
+        FlushBatch(&shapeBatch, true);
+        ProfileEnd();
+
+        ProfileBegin(PZ_DRAW_LABELS);
+        labelBatch.count = 0;
+        int labelCount = 0;
+        for(int i=0;i<frame->count;i++){
+            if(!frame->name[i][0]) continue;
+            Vector2 pos=Vector2Lerp(frame->previous[i], frame->position[i], alpha); float size=frame->size[i];
+            float tw = frame->labelWidth[i];
+            BatchQuad(&labelBatch, (int)(pos.x-tw/2-4), (int)(pos.y-size-20), (int)(pos.x-tw/2-4)+(int)(tw+8), (int)(pos.y-size-20)+16, (Color){0,0,0,150});
+            labelCount++;
+        }
+        FlushBatch(&labelBatch, true);
+        for(int i=0;i<frame->count;i++){
+            if(!frame->name[i][0]) continue;
+            Vector2 pos=Vector2Lerp(frame->previous[i], frame->position[i], alpha); float size=frame->size[i];
+            DrawTextEx(customFont, frame->name[i], (Vector2){(int)(pos.x-frame->labelWidth[i]/2), (int)(pos.y-size-18)}, LABEL_FONT_SIZE, 0, WHITE);
+        }
+        renderStats.labels = labelCount;
+        if(labelCount > 0) renderStats.drawCalls++;
+        ProfileEnd();
+
+        // Enhanced Bottom command bar
+        ProfileBegin(PZ_DRAW_CONSOLE);
+        Rectangle cmdRect={0,(float)(screenH-commandBarH),(float)screenW,(float)commandBarH};
+        DrawRectangleRec(cmdRect,BG_DARK);
+        DrawRectangle(0, screenH-commandBarH, screenW, 1, BG_LIGHT);
+        
+        DrawTextEx(customFont, "> ", (Vector2){10, (int)(screenH-commandBarH)+10}, 20, 0, ACCENT_BLUE);
+        DrawTextEx(customFont, commandBuffer, (Vector2){35, (int)(screenH-commandBarH)+10}, 20, 0, TEXT_PRIMARY);
+        
+        static float cursorTimer = 0;
+        cursorTimer += GetFrameTime();
+        if(cursorTimer < 0.5f) {
+            float textWidth = MeasureText(commandBuffer, 20);
+            DrawTextEx(customFont, "_", (Vector2){35 + textWidth, (int)(screenH-commandBarH)+10}, 20, 0, ACCENT_BLUE);
+        }
+        if(cursorTimer > 1.0f) cursorTimer = 0;
+
+        // Enhanced Logs
+        DrawRectangle(0, screenH-commandBarH-logBarH, screenW, logBarH, BG_MEDIUM);
+        DrawRectangle(0, screenH-commandBarH-logBarH, screenW, 1, BG_LIGHT);
+        
+        // Newest entries at the bottom; the wheel over the bar scrolls back
+        unsigned int logEnd = atomic_load_explicit(&logHead, memory_order_acquire);
+        int logAvailable = logEnd < LOG_RING_CAP ? (int)logEnd : LOG_RING_CAP;
+        if(mouse.y >= screenH-commandBarH-logBarH && mouse.y < screenH-commandBarH) logScroll += (int)GetMouseWheelMove();
+        logScroll = Clamp(logScroll, 0, logAvailable > LOG_VISIBLE ? logAvailable-LOG_VISIBLE : 0);
+        int shownLogs = logAvailable < LOG_VISIBLE ? logAvailable : LOG_VISIBLE;
+        for(int i=0;i<shownLogs;i++) {
+            LogEntry entry;
+            if(!ReadLogEntry(logEnd - logScroll - shownLogs + i, &entry)) continue;
+            Color logColor = TEXT_SECONDARY;
+            if(entry.level == LOG_ERROR) logColor = ACCENT_RED;
+            else if(entry.level == LOG_WARNING) logColor = ACCENT_ORANGE;
+            else if(entry.level == LOG_SUCCESS) logColor = ACCENT_GREEN;
+            else if(entry.source != LOG_ENGINE) logColor = ACCENT_PURPLE;
+            
+            DrawTextEx(customFont, entry.text, (Vector2){15, (int)(screenH-commandBarH-logBarH+10+i*20)}, 14, 0, logColor);
+        }
+        if(logScroll > 0) {
+            char more[32]; snprintf(more, sizeof(more), "+%d newer", logScroll);
+            DrawTextEx(customFont, more, (Vector2){(float)screenW-100, (int)(screenH-commandBarH-logBarH+10)}, 12, 0, TEXT_SECONDARY);
+        }
+
+        // Enhanced Play button
+        DrawRectangleRounded(playButton, 0.2f, 8, running ? ACCENT_GREEN : ACCENT_RED);
+        const char* buttonText = running ? "▪ Stop" : "▶ Run";
+        DrawTextEx(customFont, buttonText, (Vector2){(int)playButton.x+15, (int)playButton.y+10}, 18, 0, WHITE);
+        ProfileEnd();
+
+        // Enhanced Script editor with syntax highlighting
+        if(activeEditor>=0){
+            ProfileBegin(PZ_DRAW_EDITOR);
+            ScriptEditor *ed=&openEditors[activeEditor];
+            int startY=tabBarH; int startX=leftPanelW;
+            Rectangle editorRect = {startX, startY, (float)(screenW-leftPanelW), (float)(screenH-bottomH-tabBarH)};
+            
+            DrawRectangleRec(editorRect, BG_DARK);
+            
+            // Draw line numbers background
+            DrawRectangle(startX, startY, 50, editorRect.height, BG_MEDIUM);
+            DrawLine(startX+50, startY, startX+50, startY+editorRect.height, BG_LIGHT);
+            
+            // Show Script status
+            if(ed->isPython) {
+                DrawTextEx(customFont, "Python Script - Press F5 to Run", (Vector2){startX + 60, startY + 5}, 12, 0, ACCENT_GREEN);
+            } else if(ed->isScript) {
+                DrawTextEx(customFont, "Custom Script - Press F5 to Run", (Vector2){startX + 60, startY + 5}, 12, 0, ACCENT_PURPLE);
+            }
+            
+            // Draw editor content with syntax highlighting
+            int contentStartY = startY + ((ed->isPython || ed->isScript) ? 25 : 10);
+            ProfileBegin(PZ_HIGHLIGHT);
+            for(int i=0;i<VISIBLE_LINES && i+ed->scroll < TextLineCount(ed->text);i++){
+                int lineIdx=i+ed->scroll;
+                int lineY = contentStartY + i*editorCharY;
+                
+                // Line number
+                char lineNum[8];
+                snprintf(lineNum, sizeof(lineNum), "%d", lineIdx + 1);
+                DrawTextEx(customFont, lineNum, (Vector2){startX + 10, lineY}, 14, 0, TEXT_SECONDARY);
+                
+                // Line content: cached spans, one draw each
+                DrawEditorLine(ed, lineIdx, customFont, (Vector2){startX + 60, lineY});
+            }
+            ProfileEnd();
+            
+            // Enhanced Caret
+            if(caretLine >= ed->scroll && caretLine < ed->scroll + VISIBLE_LINES) {
+                int caretX = startX + 60 + (int)EditorLineLayout(ed, caretLine, customFont)->advance[caretCol];
+                int caretY = contentStartY + (caretLine - ed->scroll) * editorCharY;
+                
+                static float caretBlink = 0;
+                caretBlink += GetFrameTime();
+                if(caretBlink < 0.5f) {
+                    DrawLine(caretX, caretY, caretX, caretY + editorCharY - 2, ACCENT_BLUE);
+                }
+                if(caretBlink > 1.0f) caretBlink = 0;
+            }
+            
+            // Current line highlight
+            if(caretLine >= ed->scroll && caretLine < ed->scroll + VISIBLE_LINES) {
+                int highlightY = contentStartY + (caretLine - ed->scroll) * editorCharY;
+                DrawRectangle(startX + 50, highlightY - 2, screenW - leftPanelW - 50, editorCharY, (Color){ACCENT_BLUE.r, ACCENT_BLUE.g, ACCENT_BLUE.b, 20});
+            }
+            ProfileEnd();
+        }
+
+        // Help text
+        DrawTextEx(customFont, "Commands: NewScript/NewPython <n>, RunScript/RunPython <n>, set var value", (Vector2){10, screenH-15}, 10, 0, TEXT_SECONDARY);
+        if(profileOverlay) DrawProfileOverlay(customFont, canvas);
+        ProfileEnd();
+
+        ProfileBegin(PZ_PRESENT);
+        EndDrawing();
+        ProfileEnd();
+        ProfileEnd();
+    }
+
+    StopSimulationThread();
+    if(mainThreadState) PyEval_RestoreThread(mainThreadState);
+    ClearPythonHooks();
+    Py_Finalize();
+    JournalClose();
+    StopScriptLoader();
+    StopJobSystem();
+    StopLogWriter();
+    CloseWindow();
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+// Text buffer checks; builds against main.c with its entry point renamed:
+//   gcc -o text_buffer_test tests/text_buffer_test.c -lraylib $(python3-config --includes --ldflags --embed) -lm -lpthread
+#define main engine_main
+#include "../main.c"
+#undef main
+
+static int failures = 0;
+
+static void Check(bool ok, const char* what){
+    if(!ok){ printf("FAIL: %s\n", what); failures++; }
+}
+
+static TextBuffer* LoadText(const char* path, const char* text){
+    FILE* f = fopen(path, "wb");
+    if(!f) return NULL;
+    fputs(text, f);
+    fclose(f);
+    return TextBufferLoad(path);
+}
+
+// Growing a loaded line must not spill into the lines after it
+static void TestInsertIntoFirstLine(const char* text, const char* first, const char* second){
+    const char* path = "text_buffer_test.tmp";
+    TextBuffer* b = LoadText(path, text);
+    remove(path);
+    Check(b != NULL, "load");
+    if(!b) return;
+    Check(TextLineCount(b) == 2, "line count");
+    for(int n = 0; n < 40; n++) TextLineInsertChar(b, 0, TextLineAt(b, 0)->len, 'x');
+    char expect[64];
+    snprintf(expect, sizeof(expect), "%s%.*s", first, 40, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+    Check(strcmp(TextLineAt(b, 0)->text, expect) == 0, "first line grows");
+    Check(strcmp(TextLineAt(b, 1)->text, second) == 0, "second line untouched");
+    TextBufferRelease(b);
+}
+
+int main(void){
+    TestInsertIntoFirstLine("ab\nc", "ab", "c");
+    TestInsertIntoFirstLine("ab\ncd\n", "ab", "cd");
+    TestInsertIntoFirstLine("\nc", "", "c");
+    if(failures == 0) printf("text buffer: ok\n");
+    return failures ? 1 : 0;
+}